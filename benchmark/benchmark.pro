@@ -0,0 +1,27 @@
+TEMPLATE = app
+TARGET = qwt_benchmark
+
+CONFIG += console
+CONFIG -= app_bundle
+
+QT += widgets concurrent
+
+# Headless benchmark for the rendering hot paths.
+# Builds against the static library in ../lib by default.
+# To compare with another Qwt build ( f.e. upstream 6.1 ) use:
+#   qmake QWT_INCLUDE=/path/to/qwt/src QWT_LIB=/path/to/qwt/lib
+
+isEmpty(QWT_INCLUDE) {
+    QWT_INCLUDE = $$PWD/..
+}
+
+isEmpty(QWT_LIB) {
+    QWT_LIB = $$PWD/../lib
+}
+
+INCLUDEPATH += $$QWT_INCLUDE
+DEPENDPATH += $$QWT_INCLUDE
+LIBS += -L$$QWT_LIB -lqwt
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,629 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+/*
+  Headless benchmark for the rendering hot paths.
+
+  All painting is done on QImage paint devices, the application is
+  started on the "offscreen" QPA platform unless QT_QPA_PLATFORM is set.
+  Results are written to stdout as one JSON object per line:
+
+  {"suite":"curve","case":"Lines","points":1000,"threads":1,
+   "iterations":812,"ms":0.246}
+
+  Only API, that is available in upstream Qwt 6.1 too, is used, so the
+  same source can be built against both libraries ( see benchmark.pro ).
+  The exception are regression checks of features of this library,
+  that are reported as {"suite":"check",...} and make the benchmark
+  exit with 1, when they fail.
+
+  Options:
+    --max-points N   largest number of curve samples ( default 1e8 )
+    --min-time MS    minimum measuring time for each case ( default 200 )
+    --filter TEXT    run only cases, where "suite/case" contains TEXT
+*/
+
+#include <qapplication.h>
+#include <qimage.h>
+#include <qpainter.h>
+#include <qelapsedtimer.h>
+#include <qstringlist.h>
+#include <qtextstream.h>
+#include <qthread.h>
+#include <qmath.h>
+#include <qwt_plot.h>
+#include <qwt_plot_canvas.h>
+#include <qwt_plot_curve.h>
+#include <qwt_plot_grid.h>
+#include <qwt_plot_layout.h>
+#include <qwt_plot_renderer.h>
+#include <qwt_plot_spectrogram.h>
+#include <qwt_raster_data.h>
+#include <qwt_color_map.h>
+#include <qwt_scale_engine.h>
+#include <qwt_scale_div.h>
+#include <qwt_symbol.h>
+
+#if defined(QWT_VERSION) && QWT_VERSION >= 0x060100
+typedef size_t QwtBenchIndex;
+typedef QwtLogScaleEngine QwtBenchLogScaleEngine;
+#else
+typedef int QwtBenchIndex;
+typedef QwtLog10ScaleEngine QwtBenchLogScaleEngine;
+#endif
+
+class BenchOptions
+{
+public:
+    BenchOptions():
+        maxPoints( 100000000 ),
+        minTime( 200 ),
+        canvasSize( 1000, 600 )
+    {
+    }
+
+    qint64 maxPoints;
+    int minTime;
+    QString filter;
+    QSize canvasSize;
+};
+
+/*
+  Samples are calculated on the fly, so that the largest
+  curves don't need gigabytes of memory.
+ */
+class SineData: public QwtSeriesData<QPointF>
+{
+public:
+    SineData( int size ):
+        d_size( size ),
+        d_factor( 40.0 * M_PI / qMax( size, 1 ) )
+    {
+        d_boundingRect = QRectF( 0.0, -1.1, size, 2.2 );
+    }
+
+    virtual QwtBenchIndex size() const
+    {
+        return d_size;
+    }
+
+    virtual QPointF sample( QwtBenchIndex i ) const
+    {
+        // cheap deterministic noise, so that neighboured
+        // samples don't end up in the same pixel
+        const double noise =
+            ( ( uint( i ) * 2654435761u ) & 0xffff ) / 65536.0 - 0.5;
+
+        const double x = double( i );
+        return QPointF( x, qSin( x * d_factor ) + 0.1 * noise );
+    }
+
+    virtual QRectF boundingRect() const
+    {
+        return d_boundingRect;
+    }
+
+private:
+    const int d_size;
+    const double d_factor;
+};
+
+class FunctionData: public QwtRasterData
+{
+public:
+    FunctionData()
+    {
+        setInterval( Qt::XAxis, QwtInterval( -1.5, 1.5 ) );
+        setInterval( Qt::YAxis, QwtInterval( -1.5, 1.5 ) );
+        setInterval( Qt::ZAxis, QwtInterval( 0.0, 10.0 ) );
+    }
+
+    virtual double value( double x, double y ) const
+    {
+        const double c = 0.842;
+
+        const double v1 = x * x + ( y - c ) * ( y + c );
+        const double v2 = x * ( y + c ) + x * ( y + c );
+
+        return 1.0 / ( v1 * v1 + v2 * v2 );
+    }
+};
+
+class Bench
+{
+public:
+    Bench( const BenchOptions &options ):
+        d_options( options ),
+        d_out( stdout )
+    {
+    }
+
+    bool isEnabled( const char *suite, const QString &name ) const
+    {
+        if ( d_options.filter.isEmpty() )
+            return true;
+
+        const QString id = QString( suite ) + "/" + name;
+        return id.contains( d_options.filter );
+    }
+
+    template <typename Func>
+    void run( const char *suite, const QString &name,
+        qint64 points, int threads, Func &func )
+    {
+        if ( !isEnabled( suite, name ) )
+            return;
+
+        if ( points < 1000000 )
+            func(); // warm up caches and lazy initializations
+
+        QElapsedTimer timer;
+        timer.start();
+
+        int iterations = 0;
+        do
+        {
+            func();
+            iterations++;
+        }
+        while ( timer.elapsed() < d_options.minTime );
+
+        const double ms = timer.nsecsElapsed() / 1.0e6 / iterations;
+
+        d_out << "{\"suite\":\"" << suite << "\""
+            << ",\"case\":\"" << name << "\""
+            << ",\"points\":" << points
+            << ",\"threads\":" << threads
+            << ",\"iterations\":" << iterations
+            << ",\"ms\":" << QString::number( ms, 'f', 3 )
+            << "}\n";
+        d_out.flush();
+    }
+
+    void info()
+    {
+#if defined(QWT_VERSION_STR)
+        const QString library = QString( "Qwt " ) + QWT_VERSION_STR;
+#else
+        const QString library = "SimpleQWT";
+#endif
+        d_out << "{\"suite\":\"info\""
+            << ",\"library\":\"" << library << "\""
+            << ",\"qt\":\"" << qVersion() << "\""
+            << ",\"platform\":\"" << QApplication::platformName() << "\""
+            << ",\"idealThreadCount\":" << QThread::idealThreadCount()
+            << "}\n";
+        d_out.flush();
+    }
+
+    const BenchOptions &options() const
+    {
+        return d_options;
+    }
+
+private:
+    const BenchOptions &d_options;
+    QTextStream d_out;
+};
+
+/*
+  Paints the items of a plot into an image of the canvas size
+  the same way QwtPlotCanvas does it.
+ */
+class CanvasPainter
+{
+public:
+    CanvasPainter( QwtPlot *plot ):
+        d_plot( plot )
+    {
+        d_plot->updateAxes();
+        d_plot->updateLayout();
+
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+            d_maps[axisId] = d_plot->canvasMap( axisId );
+
+        d_canvasRect = d_plot->canvas()->contentsRect();
+        d_image = QImage( d_plot->canvas()->size(),
+            QImage::Format_ARGB32_Premultiplied );
+    }
+
+    void operator()()
+    {
+        d_image.fill( 0xffffffff );
+
+        QPainter painter( &d_image );
+        d_plot->drawItems( &painter, d_canvasRect, d_maps );
+    }
+
+private:
+    QwtPlot *d_plot;
+    QwtScaleMap d_maps[QwtPlot::axisCnt];
+    QRectF d_canvasRect;
+    QImage d_image;
+};
+
+class ScaleDivider
+{
+public:
+    ScaleDivider( const QwtScaleEngine *engine, double min, double max ):
+        d_engine( engine ),
+        d_min( min ),
+        d_max( max ),
+        d_ticks( 0 )
+    {
+    }
+
+    void operator()()
+    {
+        double range = d_max;
+        for ( int i = 0; i < 1000; i++ )
+        {
+            const QwtScaleDiv div = d_engine->divideScale(
+                d_min, range, 8, 5 );
+            d_ticks += div.ticks( QwtScaleDiv::MajorTick ).count();
+
+            range *= 1.01;
+        }
+    }
+
+private:
+    const QwtScaleEngine *d_engine;
+    const double d_min;
+    const double d_max;
+    int d_ticks;
+};
+
+class LayoutActivator
+{
+public:
+    LayoutActivator( QwtPlot *plot ):
+        d_plot( plot ),
+        d_count( 0 )
+    {
+    }
+
+    void operator()()
+    {
+        // alternate the size to avoid hitting any cache
+        const int d = ( d_count++ % 2 ) * 10;
+
+        d_plot->plotLayout()->activate( d_plot,
+            QRectF( 0, 0, 1000 + d, 600 + d ) );
+    }
+
+private:
+    QwtPlot *d_plot;
+    int d_count;
+};
+
+class PlotRenderer
+{
+public:
+    PlotRenderer( QwtPlot *plot, const QSize &size ):
+        d_plot( plot ),
+        d_image( size, QImage::Format_ARGB32_Premultiplied )
+    {
+    }
+
+    void operator()()
+    {
+        d_image.fill( 0xffffffff );
+
+        QPainter painter( &d_image );
+        d_renderer.render( d_plot, &painter, QRectF( d_image.rect() ) );
+    }
+
+private:
+    QwtPlot *d_plot;
+    QwtPlotRenderer d_renderer;
+    QImage d_image;
+};
+
+static QList<int> sampleCounts( const BenchOptions &options )
+{
+    QList<int> counts;
+    for ( qint64 n = 1000; n <= options.maxPoints; n *= 10 )
+        counts += int( n );
+
+    return counts;
+}
+
+static QwtPlot *createPlot( const BenchOptions &options )
+{
+    QwtPlot *plot = new QwtPlot();
+    plot->setTitle( "Benchmark" );
+    plot->setAxisTitle( QwtPlot::xBottom, "Samples" );
+    plot->setAxisTitle( QwtPlot::yLeft, "Value" );
+    plot->resize( options.canvasSize + QSize( 80, 80 ) );
+    plot->updateLayout();
+
+    return plot;
+}
+
+static void benchCurves( Bench &bench )
+{
+    struct
+    {
+        const char *name;
+        QwtPlotCurve::CurveStyle style;
+        QwtSymbol::Style symbol;
+        bool antialiased;
+    } cases[] =
+    {
+        { "Lines", QwtPlotCurve::Lines, QwtSymbol::NoSymbol, false },
+        { "Lines/Antialiased", QwtPlotCurve::Lines, QwtSymbol::NoSymbol, true },
+        { "Sticks", QwtPlotCurve::Sticks, QwtSymbol::NoSymbol, false },
+        { "Steps", QwtPlotCurve::Steps, QwtSymbol::NoSymbol, false },
+        { "Dots", QwtPlotCurve::Dots, QwtSymbol::NoSymbol, false },
+        { "Symbols/Ellipse", QwtPlotCurve::NoCurve, QwtSymbol::Ellipse, false },
+        { "Symbols/Ellipse/Antialiased",
+            QwtPlotCurve::NoCurve, QwtSymbol::Ellipse, true },
+        { "Symbols/Rect", QwtPlotCurve::NoCurve, QwtSymbol::Rect, false },
+        { "Symbols/XCross", QwtPlotCurve::NoCurve, QwtSymbol::XCross, false }
+    };
+
+    QwtPlot *plot = createPlot( bench.options() );
+    plot->setAxisScale( QwtPlot::yLeft, -1.2, 1.2 );
+
+    const QList<int> counts = sampleCounts( bench.options() );
+    for ( uint i = 0; i < sizeof( cases ) / sizeof( cases[0] ); i++ )
+    {
+        if ( !bench.isEnabled( "curve", cases[i].name ) )
+            continue;
+
+        for ( int j = 0; j < counts.size(); j++ )
+        {
+            const int numPoints = counts[j];
+
+            QwtPlotCurve *curve = new QwtPlotCurve();
+            curve->setStyle( cases[i].style );
+            curve->setRenderHint( QwtPlotItem::RenderAntialiased,
+                cases[i].antialiased );
+            if ( cases[i].symbol != QwtSymbol::NoSymbol )
+            {
+                curve->setSymbol( new QwtSymbol( cases[i].symbol,
+                    QBrush( Qt::yellow ), QPen( Qt::blue ), QSize( 5, 5 ) ) );
+            }
+            curve->setData( new SineData( numPoints ) );
+            curve->attach( plot );
+
+            plot->setAxisScale( QwtPlot::xBottom, 0.0, numPoints );
+
+            CanvasPainter canvasPainter( plot );
+            bench.run( "curve", cases[i].name, numPoints, 1, canvasPainter );
+
+            curve->detach();
+            delete curve;
+        }
+    }
+
+    delete plot;
+}
+
+static void benchSpectrogram( Bench &bench )
+{
+    QwtPlot *plot = createPlot( bench.options() );
+    plot->setAxisScale( QwtPlot::xBottom, -1.5, 1.5 );
+    plot->setAxisScale( QwtPlot::yLeft, -1.5, 1.5 );
+
+    QwtPlotSpectrogram *spectrogram = new QwtPlotSpectrogram();
+    spectrogram->setData( new FunctionData() );
+
+    QList<double> contourLevels;
+    for ( double level = 0.5; level < 10.0; level += 1.0 )
+        contourLevels += level;
+    spectrogram->setContourLevels( contourLevels );
+
+    spectrogram->attach( plot );
+
+    QList<int> threadCounts;
+    threadCounts << 1 << 2 << 4;
+    if ( !threadCounts.contains( QThread::idealThreadCount() ) )
+        threadCounts << QThread::idealThreadCount();
+
+    const QSize size = bench.options().canvasSize;
+
+    struct
+    {
+        const char *name;
+        bool image;
+        bool contour;
+    } modes[] =
+    {
+        { "Image", true, false },
+        { "Contour", false, true },
+        { "ImageContour", true, true }
+    };
+
+    for ( uint i = 0; i < sizeof( modes ) / sizeof( modes[0] ); i++ )
+    {
+        spectrogram->setDisplayMode(
+            QwtPlotSpectrogram::ImageMode, modes[i].image );
+        spectrogram->setDisplayMode(
+            QwtPlotSpectrogram::ContourMode, modes[i].contour );
+
+        for ( int j = 0; j < threadCounts.size(); j++ )
+        {
+            spectrogram->setRenderThreadCount( threadCounts[j] );
+
+            CanvasPainter canvasPainter( plot );
+            bench.run( "spectrogram", modes[i].name,
+                qint64( size.width() ) * size.height(),
+                threadCounts[j], canvasPainter );
+        }
+    }
+
+    delete plot;
+}
+
+static void benchScaleEngine( Bench &bench )
+{
+    QwtLinearScaleEngine linearEngine;
+    ScaleDivider linearDivider( &linearEngine, -3.7, 1234.5 );
+    bench.run( "scaleEngine", "Linear", 1000, 1, linearDivider );
+
+    QwtBenchLogScaleEngine logEngine;
+    ScaleDivider logDivider( &logEngine, 1.0e-3, 1.0e5 );
+    bench.run( "scaleEngine", "Log10", 1000, 1, logDivider );
+}
+
+static void benchLayout( Bench &bench )
+{
+    QwtPlot *plot = createPlot( bench.options() );
+    plot->enableAxis( QwtPlot::yRight );
+    plot->enableAxis( QwtPlot::xTop );
+    plot->updateAxes();
+
+    LayoutActivator activator( plot );
+    bench.run( "layout", "activate", 1, 1, activator );
+
+    delete plot;
+}
+
+static void benchRenderer( Bench &bench )
+{
+    QwtPlot *plot = createPlot( bench.options() );
+    plot->setAxisScale( QwtPlot::yLeft, -1.2, 1.2 );
+
+    QwtPlotGrid *grid = new QwtPlotGrid();
+    grid->attach( plot );
+
+    QwtPlotCurve *curve = new QwtPlotCurve( "Curve" );
+    curve->attach( plot );
+
+    QList<int> counts;
+    counts << 1000 << 100000;
+
+    for ( int i = 0; i < counts.size(); i++ )
+    {
+        if ( counts[i] > bench.options().maxPoints )
+            break;
+
+        curve->setData( new SineData( counts[i] ) );
+        plot->setAxisScale( QwtPlot::xBottom, 0.0, counts[i] );
+        plot->updateAxes();
+
+        PlotRenderer renderer( plot, bench.options().canvasSize );
+        bench.run( "renderer", "render", counts[i], 1, renderer );
+    }
+
+    delete plot;
+}
+
+#if !defined(QWT_VERSION)
+
+/*
+  A spike, that returns close to its start, must not be dropped
+  by the simplification of QwtPlotCurve::drawSimplified()
+ */
+static bool checkSimplifiedSpike()
+{
+    QVector<QPointF> samples;
+    samples += QPointF( 0.0, 20.0 );
+    samples += QPointF( 40.0, 20.0 );
+    samples += QPointF( 0.4, 20.0 );
+    samples += QPointF( 80.0, 40.0 );
+
+    QwtPlotCurve curve;
+    curve.setSamples( samples );
+
+    // paint device coordinates = plot coordinates
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( 0.0, 100.0 );
+    xMap.setPaintInterval( 0.0, 100.0 );
+
+    QwtScaleMap yMap = xMap;
+
+    QImage image( 100, 100, QImage::Format_ARGB32_Premultiplied );
+    image.fill( 0 );
+
+    QPainter painter( &image );
+    curve.drawSimplified( &painter, xMap, yMap, image.rect(), 1.0 );
+    painter.end();
+
+    // the tip of the spike, far away from the line to the last point
+    for ( int y = 19; y <= 21; y++ )
+    {
+        if ( qAlpha( image.pixel( 38, y ) ) != 0 )
+            return true;
+    }
+
+    return false;
+}
+
+#endif
+
+static int runChecks( QTextStream &out )
+{
+    struct
+    {
+        const char *name;
+        bool ( *check )();
+    } checks[] =
+    {
+#if !defined(QWT_VERSION)
+        { "simplification/spike", checkSimplifiedSpike },
+#endif
+        { NULL, NULL }
+    };
+
+    int failed = 0;
+    for ( uint i = 0; checks[i].check != NULL; i++ )
+    {
+        const bool ok = checks[i].check();
+        if ( !ok )
+            failed++;
+
+        out << "{\"suite\":\"check\""
+            << ",\"case\":\"" << checks[i].name << "\""
+            << ",\"ok\":" << ( ok ? "true" : "false" )
+            << "}\n";
+    }
+    out.flush();
+
+    return failed;
+}
+
+int main( int argc, char **argv )
+{
+#if QT_VERSION >= 0x050000
+    if ( qgetenv( "QT_QPA_PLATFORM" ).isEmpty() )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+#endif
+
+    QApplication app( argc, argv );
+
+    BenchOptions options;
+
+    const QStringList args = app.arguments();
+    for ( int i = 1; i < args.size() - 1; i++ )
+    {
+        if ( args[i] == "--max-points" )
+            options.maxPoints = args[++i].toDouble();
+        else if ( args[i] == "--min-time" )
+            options.minTime = args[++i].toInt();
+        else if ( args[i] == "--filter" )
+            options.filter = args[++i];
+    }
+
+    Bench bench( options );
+    bench.info();
+
+    QTextStream out( stdout );
+    if ( runChecks( out ) > 0 )
+        return 1;
+
+    benchCurves( bench );
+    benchSpectrogram( bench );
+    benchScaleEngine( bench );
+    benchLayout( bench );
+    benchRenderer( bench );
+
+    return 0;
+}
@@ -63,6 +63,7 @@ HEADERS += \
     qwt_legend_itemmanager.h \
     qwt_plot.h \
     qwt_plot_renderer.h \
+    qwt_plot_scene.h \
     qwt_plot_curve.h \
     qwt_plot_dict.h \
     qwt_plot_directpainter.h \
@@ -72,10 +73,21 @@ HEADERS += \
     qwt_plot_marker.h \
     qwt_plot_rasteritem.h \
     qwt_plot_spectrogram.h \
+    qwt_plot_traces.h \
+    qwt_pixel_matrix.h \
     qwt_plot_seriesitem.h \
     qwt_plot_canvas.h \
     qwt_raster_data.h \
     qwt_series_data.h \
+    qwt_mapped_series_data.h \
+    qwt_chunked_series_data.h \
+    qwt_series_snapshot.h \
+    qwt_circular_series_data.h \
+    qwt_series_provider.h \
+    qwt_async_series_data.h \
+    qwt_compressed_series_data.h \
+    qwt_multichannel_data.h \
+    qwt_uniform_data.h \
     qwt_scale_widget.h
 
 SOURCES += \
@@ -83,6 +95,7 @@ SOURCES += \
     qwt_legend_item.cpp \
     qwt_plot.cpp \
     qwt_plot_renderer.cpp \
+    qwt_plot_scene.cpp \
     qwt_plot_axis.cpp \
     qwt_plot_curve.cpp \
     qwt_plot_dict.cpp \
@@ -90,6 +103,8 @@ SOURCES += \
     qwt_plot_grid.cpp \
     qwt_plot_item.cpp \
     qwt_plot_spectrogram.cpp \
+    qwt_plot_traces.cpp \
+    qwt_pixel_matrix.cpp \
     qwt_plot_seriesitem.cpp \
     qwt_plot_marker.cpp \
     qwt_plot_layout.cpp \
@@ -97,6 +112,14 @@ SOURCES += \
     qwt_plot_rasteritem.cpp \
     qwt_raster_data.cpp \
     qwt_series_data.cpp \
+    qwt_mapped_series_data.cpp \
+    qwt_chunked_series_data.cpp \
+    qwt_series_snapshot.cpp \
+    qwt_circular_series_data.cpp \
+    qwt_series_provider.cpp \
+    qwt_async_series_data.cpp \
+    qwt_compressed_series_data.cpp \
+    qwt_multichannel_data.cpp \
     qwt_scale_widget.cpp
 
 HEADERS += \
@@ -0,0 +1,556 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_async_series_data.h"
+#include "qwt_series_provider.h"
+#include "qwt_interval.h"
+#include <qmap.h>
+#include <qpair.h>
+#include <qmath.h>
+#include <qthread.h>
+#include <qmutex.h>
+#include <qfuturewatcher.h>
+#include <qtconcurrentrun.h>
+
+typedef QPair<int, qint64> QwtTileKey;
+typedef QFutureWatcher< QVector<QPointF> > QwtTileWatcher;
+
+static void qwtIndexRange( const QVector<QPointF> &samples,
+    double x1, double x2, int &from, int &to )
+{
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    int lo = 0;
+    int hi = samples.size();
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( samples[mid].x() < x1 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    from = lo;
+
+    hi = samples.size();
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( samples[mid].x() <= x2 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    to = lo - 1;
+}
+
+// maximum number of tiles, that are loading at the same time
+static const int qwtMaxPendingTiles = 8;
+
+class QwtAsyncSeriesData::Tile
+{
+public:
+    Tile():
+        resolution( 0 ),
+        watcher( NULL ),
+        loaded( false ),
+        lastUsed( 0 )
+    {
+    }
+
+    QwtInterval interval;
+    QVector<QPointF> samples;
+
+    // resolution of the pending or last request
+    int resolution;
+
+    // the tile is loading as long as it has a watcher
+    QwtTileWatcher *watcher;
+    bool loaded;
+
+    quint64 lastUsed;
+};
+
+class QwtAsyncSeriesData::PrivateData
+{
+public:
+    PrivateData():
+        provider( NULL ),
+        resolution( 1024 ),
+        cacheSize( 64 ),
+        clock( 0 ),
+        numPending( 0 ),
+        level( 0 ),
+        firstTile( 0 ),
+        lastTile( -1 ),
+        prefetchFrom( 0 ),
+        prefetchTo( -1 )
+    {
+    }
+
+    QwtSeriesProvider *provider;
+
+    int resolution;
+    int cacheSize;
+
+    QMap<QwtTileKey, QwtAsyncSeriesData::Tile *> tiles;
+    quint64 clock;
+    int numPending;
+
+    // visible tiles
+    int level;
+    qint64 firstTile;
+    qint64 lastTile;
+
+    // visible tiles and their neighbours
+    qint64 prefetchFrom;
+    qint64 prefetchTo;
+
+    // samples of the visible tiles, modified in the thread of the object
+    QVector<QPointF> samples;
+
+    /*
+      Copy of samples, that is taken by setRectOfInterest() in the
+      painting thread. As QVector is implicitly shared, replacing
+      samples doesn't affect a paint operation in another thread.
+     */
+    QMutex mutex;
+    QVector<QPointF> painted;
+};
+
+/*!
+  Constructor
+
+  \param provider Provider of the samples. The series takes 
+                  ownership of it.
+  \param parent Parent object
+*/
+QwtAsyncSeriesData::QwtAsyncSeriesData( 
+        QwtSeriesProvider *provider, QObject *parent ):
+    QObject( parent )
+{
+    d_data = new PrivateData;
+    d_data->provider = provider;
+}
+
+/*!
+  Destructor
+
+  Waits for pending requests, before the provider is deleted.
+*/
+QwtAsyncSeriesData::~QwtAsyncSeriesData()
+{
+    for ( QMap<QwtTileKey, Tile *>::iterator it = d_data->tiles.begin();
+        it != d_data->tiles.end(); ++it )
+    {
+        Tile *tile = it.value();
+        if ( tile->watcher )
+            tile->watcher->waitForFinished();
+
+        delete tile;
+    }
+
+    delete d_data->provider;
+    delete d_data;
+}
+
+//! \return Provider of the samples
+QwtSeriesProvider *QwtAsyncSeriesData::provider() const
+{
+    return d_data->provider;
+}
+
+/*!
+  Set the number of samples, that are requested for a tile
+
+  The visible interval is covered by 2 or 3 tiles. Changing 
+  the resolution clears the cache.
+
+  \param resolution Number of samples per tile
+  \sa resolution(), QwtSeriesProvider::samples()
+*/
+void QwtAsyncSeriesData::setResolution( int resolution )
+{
+    resolution = qMax( resolution, 1 );
+    if ( resolution == d_data->resolution )
+        return;
+
+    d_data->resolution = resolution;
+
+    /*
+      Loaded tiles are outdated. Pending ones are requested again,
+      when they have arrived.
+     */
+
+    for ( QMap<QwtTileKey, Tile *>::iterator it = d_data->tiles.begin();
+        it != d_data->tiles.end(); )
+    {
+        if ( it.value()->watcher == NULL )
+        {
+            delete it.value();
+            it = d_data->tiles.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/*!
+  \return Number of samples, that are requested for a tile
+  \sa setResolution()
+*/
+int QwtAsyncSeriesData::resolution() const
+{
+    return d_data->resolution;
+}
+
+/*!
+  Set the maximum number of cached tiles
+  \param cacheSize Number of tiles
+  \sa cacheSize()
+*/
+void QwtAsyncSeriesData::setCacheSize( int cacheSize )
+{
+    d_data->cacheSize = qMax( cacheSize, 8 );
+    expireTiles();
+}
+
+/*!
+  \return Maximum number of cached tiles
+  \sa setCacheSize()
+*/
+int QwtAsyncSeriesData::cacheSize() const
+{
+    return d_data->cacheSize;
+}
+
+/*!
+  Request samples from the provider in a worker thread
+
+  \param interval Interval of the x axis
+  \param resolution Number of samples, that are sufficient to
+                    display the interval
+
+  \return Future of the samples
+  \sa QwtSeriesProvider::samples()
+*/
+QFuture< QVector<QPointF> > QwtAsyncSeriesData::request( 
+    const QwtInterval &interval, int resolution ) const
+{
+    return QtConcurrent::run( 
+        static_cast<const QwtSeriesProvider *>( d_data->provider ),
+        &QwtSeriesProvider::samples, interval, resolution );
+}
+
+//! \return Number of samples of the visible tiles
+int QwtAsyncSeriesData::size() const
+{
+    return d_data->painted.size();
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+QPointF QwtAsyncSeriesData::sample( int i ) const
+{
+    return d_data->painted[i];
+}
+
+//! \return Bounding rectangle of the provider
+QRectF QwtAsyncSeriesData::boundingRect() const
+{
+    if ( d_data->provider == NULL )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    return d_data->provider->boundingRect();
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+  by a binary search
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return true
+*/
+bool QwtAsyncSeriesData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    qwtIndexRange( d_data->painted, x1, x2, from, to );
+    return true;
+}
+
+/*!
+  Request the tiles of the visible interval and prefetch its neighbours
+
+  Tiles are requested in the thread of the series object only. When the
+  curve is painted in another thread - f.e. by QwtPlotScene - the samples,
+  that have been loaded before, are painted.
+
+  Not more than 8 tiles are loading at the same time. The other
+  tiles are requested, when a pending one has arrived, and only
+  when they are still visible or next to the visible ones.
+
+  \param rect Visible rectangle in plot coordinates
+*/
+void QwtAsyncSeriesData::setRectOfInterest( const QRectF &rect )
+{
+    if ( d_data->provider == NULL || !( rect.width() > 0.0 ) )
+        return;
+
+    if ( QThread::currentThread() != thread() )
+    {
+        // painting the samples, that have been loaded before
+
+        QMutexLocker locker( &d_data->mutex );
+        d_data->painted = d_data->samples;
+
+        return;
+    }
+
+    // 1 <= rect.width() / tileWidth < 2
+
+    const int level = qFloor( qLn( rect.width() ) / qLn( 2.0 ) );
+    const double tileWidth = qPow( 2.0, level );
+
+    const qint64 firstTile = qint64( ::floor( rect.left() / tileWidth ) );
+    const qint64 lastTile = qint64( ::floor( rect.right() / tileWidth ) );
+
+    int direction = 0;
+    if ( level == d_data->level )
+    {
+        if ( firstTile < d_data->firstTile )
+            direction = -1;
+        else if ( lastTile > d_data->lastTile )
+            direction = 1;
+    }
+
+    const bool changed = level != d_data->level ||
+        firstTile != d_data->firstTile || lastTile != d_data->lastTile;
+
+    // prefetching the neighbours, with one more in the direction of panning
+
+    qint64 prefetchFrom = firstTile - ( direction < 0 ? 2 : 1 );
+    qint64 prefetchTo = lastTile + ( direction > 0 ? 2 : 1 );
+
+    const QRectF boundingRect = d_data->provider->boundingRect();
+    if ( boundingRect.isValid() )
+    {
+        prefetchFrom = qMax( prefetchFrom, qMin( firstTile,
+            qint64( ::floor( boundingRect.left() / tileWidth ) ) ) );
+        prefetchTo = qMin( prefetchTo, qMax( lastTile,
+            qint64( ::floor( boundingRect.right() / tileWidth ) ) ) );
+    }
+
+    d_data->level = level;
+    d_data->firstTile = firstTile;
+    d_data->lastTile = lastTile;
+    d_data->prefetchFrom = prefetchFrom;
+    d_data->prefetchTo = prefetchTo;
+
+    for ( qint64 i = prefetchFrom; i <= prefetchTo; i++ )
+        tile( level, i );
+
+    requestTiles();
+    expireTiles();
+
+    if ( changed )
+        updateSamples();
+
+    QMutexLocker locker( &d_data->mutex );
+    d_data->painted = d_data->samples;
+}
+
+void QwtAsyncSeriesData::tileLoaded()
+{
+    QwtTileWatcher *watcher = static_cast<QwtTileWatcher *>( sender() );
+
+    d_data->numPending--;
+
+    for ( QMap<QwtTileKey, Tile *>::iterator it = d_data->tiles.begin();
+        it != d_data->tiles.end(); ++it )
+    {
+        Tile *tile = it.value();
+        if ( tile->watcher != watcher )
+            continue;
+
+        tile->watcher = NULL;
+
+        /*
+          A tile of an outdated resolution is requested again
+          by requestTiles(), when it is still visible or prefetched.
+         */
+        if ( tile->resolution != d_data->resolution )
+            break;
+
+        tile->samples = watcher->result();
+        tile->loaded = true;
+
+        const QwtTileKey &key = it.key();
+
+        if ( key.first == d_data->level && 
+            key.second >= d_data->firstTile && key.second <= d_data->lastTile )
+        {
+            updateSamples();
+            Q_EMIT dataChanged();
+        }
+
+        break;
+    }
+
+    watcher->deleteLater();
+
+    requestTiles();
+}
+
+QwtAsyncSeriesData::Tile *QwtAsyncSeriesData::tile( int level, qint64 index )
+{
+    const QwtTileKey key( level, index );
+
+    Tile *tile = d_data->tiles.value( key, NULL );
+    if ( tile == NULL )
+    {
+        const double tileWidth = qPow( 2.0, level );
+
+        // the tile is requested by requestTiles()
+
+        tile = new Tile();
+        tile->interval = QwtInterval( 
+            index * tileWidth, ( index + 1 ) * tileWidth );
+
+        d_data->tiles.insert( key, tile );
+    }
+
+    tile->lastUsed = ++d_data->clock;
+    return tile;
+}
+
+void QwtAsyncSeriesData::requestTiles()
+{
+    // the visible tiles first, then their neighbours
+
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        const qint64 from = ( pass == 0 ) 
+            ? d_data->firstTile : d_data->prefetchFrom;
+        const qint64 to = ( pass == 0 ) 
+            ? d_data->lastTile : d_data->prefetchTo;
+
+        for ( qint64 i = from; i <= to; i++ )
+        {
+            if ( d_data->numPending >= qwtMaxPendingTiles )
+                return;
+
+            Tile *tile = d_data->tiles.value( 
+                QwtTileKey( d_data->level, i ), NULL );
+
+            if ( tile == NULL || tile->loaded || tile->watcher )
+                continue;
+
+            tile->resolution = d_data->resolution;
+            tile->watcher = new QwtTileWatcher( this );
+            connect( tile->watcher, SIGNAL( finished() ), SLOT( tileLoaded() ) );
+            tile->watcher->setFuture( 
+                request( tile->interval, d_data->resolution ) );
+
+            d_data->numPending++;
+        }
+    }
+}
+
+void QwtAsyncSeriesData::updateSamples()
+{
+    const QVector<QPointF> &previous = d_data->samples;
+
+    QVector<QPointF> samples;
+
+    for ( qint64 i = d_data->firstTile; i <= d_data->lastTile; i++ )
+    {
+        const Tile *tile = 
+            d_data->tiles.value( QwtTileKey( d_data->level, i ), NULL );
+
+        if ( tile == NULL )
+            continue;
+
+        if ( tile->loaded )
+        {
+            const QVector<QPointF> &points = tile->samples;
+
+            int j = 0;
+
+            // samples at the border between 2 tiles
+            while ( j < points.size() && !samples.isEmpty() && 
+                points[j].x() <= samples.last().x() )
+            {
+                j++;
+            }
+
+            for ( ; j < points.size(); j++ )
+                samples += points[j];
+        }
+        else
+        {
+            /*
+              Until the tile has been loaded we use, what has been
+              painted before - f.e. samples of another resolution
+             */
+            int from, to;
+            qwtIndexRange( previous, tile->interval.minValue(), 
+                tile->interval.maxValue(), from, to );
+
+            from = qMax( from, 0 );
+            if ( !samples.isEmpty() )
+            {
+                while ( from <= to && previous[from].x() <= samples.last().x() )
+                    from++;
+            }
+
+            for ( int j = from; j <= to; j++ )
+                samples += previous[j];
+        }
+    }
+
+    QMutexLocker locker( &d_data->mutex );
+    d_data->samples = samples;
+}
+
+void QwtAsyncSeriesData::expireTiles()
+{
+    while ( d_data->tiles.size() > d_data->cacheSize )
+    {
+        // the least recently used tile, that is not loading
+
+        QMap<QwtTileKey, Tile *>::iterator lru = d_data->tiles.end();
+
+        for ( QMap<QwtTileKey, Tile *>::iterator it = d_data->tiles.begin();
+            it != d_data->tiles.end(); ++it )
+        {
+            if ( it.value()->watcher == NULL && ( lru == d_data->tiles.end() ||
+                it.value()->lastUsed < lru.value()->lastUsed ) )
+            {
+                lru = it;
+            }
+        }
+
+        if ( lru == d_data->tiles.end() )
+            break;
+
+        delete lru.value();
+        d_data->tiles.erase( lru );
+    }
+}
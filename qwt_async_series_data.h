@@ -0,0 +1,94 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qobject.h>
+#include <qfuture.h>
+#include <qvector.h>
+
+class QwtSeriesProvider;
+class QwtInterval;
+
+/*!
+  \brief Series, that loads its samples asynchronously
+
+  QwtAsyncSeriesData requests the samples of the visible interval
+  from a QwtSeriesProvider in worker threads and never blocks painting. 
+  Until the requested samples have arrived the curve is painted from 
+  the best samples available - usually the ones of the previous paint
+  operation. Then dataChanged() is emitted, that should be connected
+  to QwtPlot::replot().
+
+  The x axis is divided into tiles, that are loaded and cached 
+  independently. The width of a tile is a power of 2 depending on
+  the width of the visible interval, so that panning reuses most
+  of the tiles and only loads the ones, that have been exposed.
+  The neighbours of the visible tiles - two in the direction of
+  panning - are prefetched speculatively.
+
+  \par Example
+  \verbatim
+QwtAsyncSeriesData *data = new QwtAsyncSeriesData(
+    new QwtFileSeriesProvider( "recording.dat" ) );
+QObject::connect( data, SIGNAL( dataChanged() ), plot, SLOT( replot() ) );
+curve->setData( data );
+\endverbatim
+
+  \note The visible interval is passed by setRectOfInterest(),
+        that is called, when the curve is painted. Tiles are only
+        requested, when the curve is painted in the thread of
+        the series object.
+  \note setRectOfInterest() takes a copy of the loaded samples, that is
+        used by size(), sample() and indexRange() until the next paint
+        operation. So tiles arriving in the thread of the series object
+        don't interfere with painting in another thread. But the curve
+        must not be painted by two threads at the same time.
+  \sa QwtFileSeriesProvider
+*/
+class QwtAsyncSeriesData: public QObject, public QwtSeriesData<QPointF>
+{
+    Q_OBJECT
+
+public:
+    explicit QwtAsyncSeriesData( QwtSeriesProvider *, QObject *parent = NULL );
+    virtual ~QwtAsyncSeriesData();
+
+    QwtSeriesProvider *provider() const;
+
+    void setResolution( int );
+    int resolution() const;
+
+    void setCacheSize( int );
+    int cacheSize() const;
+
+    QFuture< QVector<QPointF> > request( 
+        const QwtInterval &, int resolution ) const;
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+
+    virtual void setRectOfInterest( const QRectF & );
+
+Q_SIGNALS:
+    /*!
+      A tile of the visible interval has been loaded. 
+      The series has to be repainted.
+     */
+    void dataChanged();
+
+private Q_SLOTS:
+    void tileLoaded();
+
+private:
+    class Tile;
+
+    Tile *tile( int level, qint64 index );
+    void requestTiles();
+    void updateSamples();
+    void expireTiles();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
@@ -0,0 +1,427 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_chunked_series_data.h"
+#include <qnumeric.h>
+#include <float.h>
+
+// samples summarized by a min/max pair of a chunk
+static const int qwtBlockShift = 8;
+static const int qwtBlockSize = 1 << qwtBlockShift;
+
+class QwtChunkedSeriesData::Chunk
+{
+public:
+    explicit Chunk( int capacity ):
+        count( 0 ),
+        xMin( DBL_MAX ),
+        xMax( -DBL_MAX ),
+        yMin( DBL_MAX ),
+        yMax( -DBL_MAX )
+    {
+        points = new QPointF[capacity];
+
+        const int numBlocks = ( capacity + qwtBlockSize - 1 ) / qwtBlockSize;
+        blocks = new double[ 2 * numBlocks ];
+        for ( int i = 0; i < numBlocks; i++ )
+        {
+            blocks[2 * i] = DBL_MAX;
+            blocks[2 * i + 1] = -DBL_MAX;
+        }
+    }
+
+    ~Chunk()
+    {
+        delete[] points;
+        delete[] blocks;
+    }
+
+    inline void append( const QPointF &point )
+    {
+        const double x = point.x();
+        const double y = point.y();
+
+        // comparisons with NaN are false
+
+        if ( x < xMin )
+            xMin = x;
+        if ( x > xMax )
+            xMax = x;
+
+        if ( y < yMin )
+            yMin = y;
+        if ( y > yMax )
+            yMax = y;
+
+        double *block = blocks + 2 * ( count >> qwtBlockShift );
+        if ( y < block[0] )
+            block[0] = y;
+        if ( y > block[1] )
+            block[1] = y;
+
+        points[count++] = point;
+    }
+
+    QPointF *points;
+
+    // min/max pairs of the y coordinates of each block
+    double *blocks;
+
+    int count;
+
+    double xMin;
+    double xMax;
+    double yMin;
+    double yMax;
+};
+
+class QwtChunkedSeriesData::PrivateData
+{
+public:
+    PrivateData():
+        shift( 16 ),
+        size( 0 ),
+        sorted( true ),
+        xMin( DBL_MAX ),
+        xMax( -DBL_MAX ),
+        yMin( DBL_MAX ),
+        yMax( -DBL_MAX )
+    {
+    }
+
+    inline const QPointF &point( int index ) const
+    {
+        return chunks[index >> shift]->points[index & ( ( 1 << shift ) - 1 )];
+    }
+
+    int shift;
+    int size;
+    bool sorted;
+
+    double xMin;
+    double xMax;
+    double yMin;
+    double yMax;
+
+    QVector<QwtChunkedSeriesData::Chunk *> chunks;
+};
+
+/*!
+  Constructor
+
+  \param chunkSize Number of samples of a chunk, rounded up to 
+                   a power of 2 >= 256
+*/
+QwtChunkedSeriesData::QwtChunkedSeriesData( int chunkSize )
+{
+    d_data = new PrivateData;
+
+    d_data->shift = qwtBlockShift;
+    while ( d_data->shift < 30 && ( 1 << d_data->shift ) < chunkSize )
+        d_data->shift++;
+}
+
+//! Destructor
+QwtChunkedSeriesData::~QwtChunkedSeriesData()
+{
+    clear();
+    delete d_data;
+}
+
+//! \return Number of samples of a chunk
+int QwtChunkedSeriesData::chunkSize() const
+{
+    return 1 << d_data->shift;
+}
+
+//! \return Number of allocated chunks
+int QwtChunkedSeriesData::chunkCount() const
+{
+    return d_data->chunks.size();
+}
+
+/*!
+  \return Bounding rectangle of the samples of a chunk
+  \param chunkIndex Index of the chunk
+*/
+QRectF QwtChunkedSeriesData::chunkBoundingRect( int chunkIndex ) const
+{
+    if ( chunkIndex < 0 || chunkIndex >= d_data->chunks.size() )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    const Chunk *chunk = d_data->chunks[chunkIndex];
+    if ( chunk->xMin > chunk->xMax || chunk->yMin > chunk->yMax )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 );
+
+    return QRectF( chunk->xMin, chunk->yMin,
+        chunk->xMax - chunk->xMin, chunk->yMax - chunk->yMin );
+}
+
+/*!
+  Append a sample
+  \param point Sample
+*/
+void QwtChunkedSeriesData::append( const QPointF &point )
+{
+    PrivateData *d = d_data;
+
+    const int capacity = 1 << d->shift;
+
+    if ( ( d->size & ( capacity - 1 ) ) == 0 )
+        d->chunks += new Chunk( capacity );
+
+    if ( d->sorted && d->size > 0 )
+    {
+        if ( !( point.x() >= d->point( d->size - 1 ).x() ) )
+            d->sorted = false;
+    }
+
+    Chunk *chunk = d->chunks.last();
+    chunk->append( point );
+
+    d->xMin = qMin( d->xMin, chunk->xMin );
+    d->xMax = qMax( d->xMax, chunk->xMax );
+    d->yMin = qMin( d->yMin, chunk->yMin );
+    d->yMax = qMax( d->yMax, chunk->yMax );
+
+    d->size++;
+}
+
+/*!
+  Append samples
+
+  \param points Array of samples
+  \param size Number of samples
+*/
+void QwtChunkedSeriesData::append( const QPointF *points, int size )
+{
+    for ( int i = 0; i < size; i++ )
+        append( points[i] );
+}
+
+/*!
+  Append samples
+  \param points Samples
+*/
+void QwtChunkedSeriesData::append( const QVector<QPointF> &points )
+{
+    append( points.constData(), points.size() );
+}
+
+//! Remove all samples and free the chunks
+void QwtChunkedSeriesData::clear()
+{
+    qDeleteAll( d_data->chunks );
+    d_data->chunks.clear();
+
+    d_data->size = 0;
+    d_data->sorted = true;
+    d_data->xMin = d_data->yMin = DBL_MAX;
+    d_data->xMax = d_data->yMax = -DBL_MAX;
+}
+
+/*!
+  \return true, when the x coordinates of the samples are increasing
+  \sa indexRange()
+*/
+bool QwtChunkedSeriesData::isSorted() const
+{
+    return d_data->sorted;
+}
+
+//! \return Number of samples
+int QwtChunkedSeriesData::size() const
+{
+    return d_data->size;
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+QPointF QwtChunkedSeriesData::sample( int i ) const
+{
+    return d_data->point( i );
+}
+
+/*!
+  \return Bounding rectangle of all samples, that is updated 
+          when appending
+*/
+QRectF QwtChunkedSeriesData::boundingRect() const
+{
+    const PrivateData *d = d_data;
+    if ( d->xMin > d->xMax || d->yMin > d->yMax )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    return QRectF( d->xMin, d->yMin, d->xMax - d->xMin, d->yMax - d->yMin );
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+
+  The chunk is found by a binary search over the bounding rectangles
+  of the chunks, before searching inside of it.
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return false, when the x coordinates are not increasing
+*/
+bool QwtChunkedSeriesData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    const PrivateData *d = d_data;
+
+    if ( !d->sorted )
+        return false;
+
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    // first chunk with samples >= x1
+
+    int lo = 0;
+    int hi = d->chunks.size();
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( d->chunks[mid]->xMax < x1 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    from = lo << d->shift;
+    if ( lo < d->chunks.size() )
+    {
+        const Chunk *chunk = d->chunks[lo];
+
+        int i = 0;
+        int j = chunk->count;
+        while ( i < j )
+        {
+            const int mid = i + ( j - i ) / 2;
+            if ( chunk->points[mid].x() < x1 )
+                i = mid + 1;
+            else
+                j = mid;
+        }
+
+        from += i;
+    }
+
+    // last chunk with samples <= x2
+
+    hi = d->chunks.size();
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( d->chunks[mid]->xMin <= x2 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    to = ( lo << d->shift ) - 1;
+    if ( lo > 0 )
+    {
+        const Chunk *chunk = d->chunks[lo - 1];
+
+        int i = 0;
+        int j = chunk->count;
+        while ( i < j )
+        {
+            const int mid = i + ( j - i ) / 2;
+            if ( chunk->points[mid].x() <= x2 )
+                i = mid + 1;
+            else
+                j = mid;
+        }
+
+        to = ( ( lo - 1 ) << d->shift ) + i - 1;
+    }
+
+    return true;
+}
+
+/*!
+  Calculate the minimum and maximum of the y coordinates
+
+  Complete chunks are taken from their bounding rectangles, complete
+  blocks inside of a chunk from its summary. Only the samples at 
+  the borders are iterated.
+
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param min Minimum of the y coordinates
+  \param max Maximum of the y coordinates
+
+  \return false, when there are no valid values in the range
+*/
+bool QwtChunkedSeriesData::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    const PrivateData *d = d_data;
+
+    from = qMax( from, 0 );
+    to = qMin( to, d->size - 1 );
+
+    const int capacity = 1 << d->shift;
+
+    double lo = DBL_MAX;
+    double hi = -DBL_MAX;
+
+    int i = from;
+    while ( i <= to )
+    {
+        const Chunk *chunk = d->chunks[i >> d->shift];
+        const int index = i & ( capacity - 1 );
+
+        if ( index == 0 && i + chunk->count - 1 <= to )
+        {
+            lo = qMin( lo, chunk->yMin );
+            hi = qMax( hi, chunk->yMax );
+
+            i += chunk->count;
+        }
+        else if ( ( index & ( qwtBlockSize - 1 ) ) == 0 && 
+            i + qwtBlockSize - 1 <= to )
+        {
+            const double *block = chunk->blocks + 2 * ( index >> qwtBlockShift );
+
+            lo = qMin( lo, block[0] );
+            hi = qMax( hi, block[1] );
+
+            i += qwtBlockSize;
+        }
+        else
+        {
+            const double y = chunk->points[index].y();
+            if ( y < lo )
+                lo = y;
+            if ( y > hi )
+                hi = y;
+
+            i++;
+        }
+    }
+
+    if ( lo > hi )
+        return false;
+
+    min = lo;
+    max = hi;
+
+    return true;
+}
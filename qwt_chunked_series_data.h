@@ -0,0 +1,58 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qvector.h>
+
+/*!
+  \brief Append-only series, that is stored in chunks of fixed size
+
+  Appending to a QVector reallocates and copies all samples, whenever
+  its capacity is exhausted, what causes noticeable delays for
+  large series. QwtChunkedSeriesData stores the samples in chunks, that
+  are allocated once and never moved. Appending a sample is O(1),
+  and the address of a stored sample remains valid until clear().
+
+  Each chunk caches the bounding rectangle of its samples and
+  the minimum and maximum of the y coordinates of blocks of samples.
+  So boundingRect() is O(1), and indexRange() and yRange() skip 
+  complete chunks and blocks, what allows QwtPlotCurve to paint only 
+  the visible chunks and to decimate them to a few samples per 
+  pixel column.
+
+  \note NaN values are ignored for the bounding rectangle and 
+        the y ranges.
+*/
+class QwtChunkedSeriesData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtChunkedSeriesData( int chunkSize = 65536 );
+    virtual ~QwtChunkedSeriesData();
+
+    int chunkSize() const;
+    int chunkCount() const;
+    QRectF chunkBoundingRect( int chunkIndex ) const;
+
+    void append( const QPointF & );
+    void append( const QPointF *, int size );
+    void append( const QVector<QPointF> & );
+
+    void clear();
+
+    bool isSorted() const;
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+private:
+    QwtChunkedSeriesData( const QwtChunkedSeriesData & );
+    QwtChunkedSeriesData &operator=( const QwtChunkedSeriesData & );
+
+    class Chunk;
+
+    class PrivateData;
+    PrivateData *d_data;
+};
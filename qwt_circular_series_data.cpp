@@ -0,0 +1,319 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_circular_series_data.h"
+#include <float.h>
+
+// samples summarized by a min/max pair
+static const int qwtBlockShift = 8;
+static const int qwtBlockSize = 1 << qwtBlockShift;
+
+class QwtCircularSeriesData::PrivateData
+{
+public:
+    PrivateData():
+        first( 0 ),
+        count( 0 ),
+        timeSpan( -1.0 )
+    {
+    }
+
+    inline int position( int index ) const
+    {
+        const int pos = first + index;
+        return ( pos < points.size() ) ? pos : pos - points.size();
+    }
+
+    QVector<QPointF> points;
+
+    // min/max pairs of the y coordinates of each block
+    QVector<double> blocks;
+
+    // physical position of the oldest sample
+    int first;
+    int count;
+
+    double timeSpan;
+};
+
+/*!
+  Constructor
+
+  \param capacity Maximum number of samples, rounded up to
+                  a multiple of 256
+  \param timeSpan Samples, that are older than timeSpan compared to
+                  the latest sample, are dropped. A value <= 0.0 means
+                  no limit.
+*/
+QwtCircularSeriesData::QwtCircularSeriesData( 
+    int capacity, double timeSpan )
+{
+    d_data = new PrivateData;
+    d_data->timeSpan = timeSpan;
+
+    const int numBlocks = 
+        qMax( ( capacity + qwtBlockSize - 1 ) / qwtBlockSize, 1 );
+
+    d_data->points.resize( numBlocks * qwtBlockSize );
+    d_data->blocks.resize( 2 * numBlocks );
+}
+
+//! Destructor
+QwtCircularSeriesData::~QwtCircularSeriesData()
+{
+    delete d_data;
+}
+
+//! \return Maximum number of samples
+int QwtCircularSeriesData::capacity() const
+{
+    return d_data->points.size();
+}
+
+/*!
+  Set the time span of the window
+
+  \param timeSpan Samples, that are older than timeSpan compared to
+                  the latest sample, are dropped. A value <= 0.0 means
+                  no limit.
+  \sa timeSpan()
+*/
+void QwtCircularSeriesData::setTimeSpan( double timeSpan )
+{
+    d_data->timeSpan = timeSpan;
+    expire();
+}
+
+/*!
+  \return Time span of the window
+  \sa setTimeSpan()
+*/
+double QwtCircularSeriesData::timeSpan() const
+{
+    return d_data->timeSpan;
+}
+
+/*!
+  Append a sample
+
+  When the buffer is full, the oldest sample is overwritten.
+  \param point Sample
+*/
+void QwtCircularSeriesData::append( const QPointF &point )
+{
+    PrivateData *d = d_data;
+
+    const int pos = d->position( d->count );
+
+    if ( d->count < d->points.size() )
+    {
+        d->count++;
+    }
+    else
+    {
+        if ( ++d->first == d->points.size() )
+            d->first = 0;
+    }
+
+    double *block = d->blocks.data() + 2 * ( pos >> qwtBlockShift );
+    if ( ( pos & ( qwtBlockSize - 1 ) ) == 0 )
+    {
+        // starting a new lap of the block
+        block[0] = DBL_MAX;
+        block[1] = -DBL_MAX;
+    }
+
+    const double y = point.y();
+    if ( y < block[0] )
+        block[0] = y;
+    if ( y > block[1] )
+        block[1] = y;
+
+    d->points[pos] = point;
+
+    expire();
+}
+
+/*!
+  Append samples
+  \param points Samples
+*/
+void QwtCircularSeriesData::append( const QVector<QPointF> &points )
+{
+    for ( int i = 0; i < points.size(); i++ )
+        append( points[i] );
+}
+
+//! Remove all samples
+void QwtCircularSeriesData::clear()
+{
+    d_data->first = 0;
+    d_data->count = 0;
+}
+
+//! \return Number of samples inside of the window
+int QwtCircularSeriesData::size() const
+{
+    return d_data->count;
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index, where 0 is the oldest sample
+  \return Sample at position i
+*/
+QPointF QwtCircularSeriesData::sample( int i ) const
+{
+    return d_data->points[ d_data->position( i ) ];
+}
+
+/*!
+  \return Bounding rectangle of the samples inside of the window
+*/
+QRectF QwtCircularSeriesData::boundingRect() const
+{
+    double yMin, yMax;
+    if ( d_data->count <= 0 || !yRange( 0, d_data->count - 1, yMin, yMax ) )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    const double xMin = sample( 0 ).x();
+    const double xMax = sample( d_data->count - 1 ).x();
+
+    return QRectF( xMin, yMin, xMax - xMin, yMax - yMin );
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+  by a binary search
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return true
+*/
+bool QwtCircularSeriesData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    const PrivateData *d = d_data;
+
+    int lo = 0;
+    int hi = d->count;
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( d->points[ d->position( mid ) ].x() < x1 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    from = lo;
+
+    hi = d->count;
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( d->points[ d->position( mid ) ].x() <= x2 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    to = lo - 1;
+
+    return true;
+}
+
+/*!
+  Calculate the minimum and maximum of the y coordinates
+
+  Blocks of 256 samples are taken from their summaries, only 
+  the samples at the borders are iterated.
+
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param min Minimum of the y coordinates
+  \param max Maximum of the y coordinates
+
+  \return false, when there are no valid values in the range
+*/
+bool QwtCircularSeriesData::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    const PrivateData *d = d_data;
+
+    from = qMax( from, 0 );
+    to = qMin( to, d->count - 1 );
+
+    double lo = DBL_MAX;
+    double hi = -DBL_MAX;
+
+    int i = from;
+    while ( i <= to )
+    {
+        const int pos = d->position( i );
+
+        /*
+          A block, that is completely inside of the window, has been
+          written in one lap. So its summary is exactly about
+          the samples of the range.
+         */
+        if ( ( pos & ( qwtBlockSize - 1 ) ) == 0 && i + qwtBlockSize - 1 <= to )
+        {
+            const double *block = d->blocks.constData() + 2 * ( pos >> qwtBlockShift );
+            if ( block[0] < lo )
+                lo = block[0];
+            if ( block[1] > hi )
+                hi = block[1];
+
+            i += qwtBlockSize;
+        }
+        else
+        {
+            const double y = d->points[pos].y();
+            if ( y < lo )
+                lo = y;
+            if ( y > hi )
+                hi = y;
+
+            i++;
+        }
+    }
+
+    if ( lo > hi )
+        return false;
+
+    min = lo;
+    max = hi;
+
+    return true;
+}
+
+void QwtCircularSeriesData::expire()
+{
+    PrivateData *d = d_data;
+
+    if ( d->timeSpan <= 0.0 || d->count <= 1 )
+        return;
+
+    const double xMin = 
+        d->points[ d->position( d->count - 1 ) ].x() - d->timeSpan;
+
+    while ( d->count > 1 && d->points[d->first].x() < xMin )
+    {
+        if ( ++d->first == d->points.size() )
+            d->first = 0;
+
+        d->count--;
+    }
+}
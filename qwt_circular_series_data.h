@@ -0,0 +1,54 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qvector.h>
+
+/*!
+  \brief Sliding window of a series, stored in a circular buffer
+
+  QwtCircularSeriesData is made for strip charts, where new samples
+  are appended continuously and only the most recent ones are displayed.
+  Once the buffer is full the oldest sample is overwritten by the
+  next one. Additionally samples older than timeSpan() - relative to the
+  x coordinate of the latest sample - are dropped.
+  Appending is O(1) and never moves any sample.
+
+  The minima and maxima of the y coordinates of blocks of samples are
+  updated when appending, so that yRange() and boundingRect() don't
+  need to iterate over all samples.
+
+  \note The x coordinates have to be increasing.
+  \sa QwtPlotDirectPainter::scroll()
+*/
+class QwtCircularSeriesData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtCircularSeriesData( int capacity, double timeSpan = -1.0 );
+    virtual ~QwtCircularSeriesData();
+
+    int capacity() const;
+
+    void setTimeSpan( double );
+    double timeSpan() const;
+
+    void append( const QPointF & );
+    void append( const QVector<QPointF> & );
+
+    void clear();
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+private:
+    QwtCircularSeriesData( const QwtCircularSeriesData & );
+    QwtCircularSeriesData &operator=( const QwtCircularSeriesData & );
+
+    void expire();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
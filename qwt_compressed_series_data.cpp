@@ -0,0 +1,686 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_compressed_series_data.h"
+#include <qvector.h>
+#include <qmath.h>
+#include <float.h>
+#include <string.h>
+
+static inline int qwtLeadingZeros( quint64 value )
+{
+#if defined(__GNUC__)
+    return value ? __builtin_clzll( value ) : 64;
+#else
+    int n = 0;
+    for ( quint64 mask = Q_UINT64_C( 1 ) << 63; mask && !( value & mask ); mask >>= 1 )
+        n++;
+    return n;
+#endif
+}
+
+static inline int qwtTrailingZeros( quint64 value )
+{
+#if defined(__GNUC__)
+    return value ? __builtin_ctzll( value ) : 64;
+#else
+    int n = 0;
+    for ( quint64 mask = 1; mask && !( value & mask ); mask <<= 1 )
+        n++;
+    return n;
+#endif
+}
+
+static inline quint64 qwtBits( double value )
+{
+    quint64 bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+    return bits;
+}
+
+static inline double qwtDouble( quint64 bits )
+{
+    double value;
+    memcpy( &value, &bits, sizeof( value ) );
+    return value;
+}
+
+class QwtBitWriter
+{
+public:
+    QwtBitWriter( QVector<quint64> &words ):
+        d_words( words ),
+        d_numBits( 0 )
+    {
+        d_words.clear();
+    }
+
+    // the bits are stored starting at the least significant one
+    inline void write( quint64 value, int numBits )
+    {
+        if ( numBits <= 0 )
+            return;
+
+        if ( numBits < 64 )
+            value &= ( Q_UINT64_C( 1 ) << numBits ) - 1;
+
+        const int offset = d_numBits & 63;
+        if ( offset == 0 )
+            d_words += 0;
+
+        d_words.last() |= value << offset;
+
+        if ( offset + numBits > 64 )
+            d_words += value >> ( 64 - offset );
+
+        d_numBits += numBits;
+    }
+
+private:
+    QVector<quint64> &d_words;
+    qint64 d_numBits;
+};
+
+class QwtBitReader
+{
+public:
+    QwtBitReader( const quint64 *words ):
+        d_words( words ),
+        d_position( 0 )
+    {
+    }
+
+    inline quint64 read( int numBits )
+    {
+        if ( numBits <= 0 )
+            return 0;
+
+        const quint64 *word = d_words + ( d_position >> 6 );
+        const int offset = d_position & 63;
+
+        quint64 value = word[0] >> offset;
+        if ( offset + numBits > 64 )
+            value |= word[1] << ( 64 - offset );
+
+        if ( numBits < 64 )
+            value &= ( Q_UINT64_C( 1 ) << numBits ) - 1;
+
+        d_position += numBits;
+        return value;
+    }
+
+private:
+    const quint64 *d_words;
+    qint64 d_position;
+};
+
+class QwtCompressedSeriesData::Block
+{
+public:
+    Block():
+        min( DBL_MAX ),
+        max( -DBL_MAX ),
+        count( 0 ),
+        first( 0 ),
+        bitWidth( 0 )
+    {
+    }
+
+    // range of the values
+    double min;
+    double max;
+
+    int count;
+
+    // DeltaEncoding: first value and bits per difference
+    qint64 first;
+    int bitWidth;
+
+    QVector<quint64> words;
+};
+
+class QwtCompressedSeriesData::PrivateData
+{
+public:
+    class CacheEntry
+    {
+    public:
+        CacheEntry():
+            blockIndex( -1 ),
+            lastUsed( 0 )
+        {
+        }
+
+        int blockIndex;
+        quint64 lastUsed;
+        QVector<double> values;
+    };
+
+    PrivateData():
+        encoding( QwtCompressedSeriesData::XorEncoding ),
+        blockSize( 1024 ),
+        x0( 0.0 ),
+        dx( 1.0 ),
+        scale( 1.0 ),
+        offset( 0.0 ),
+        size( 0 ),
+        clock( 0 ),
+        lastHit( 0 )
+    {
+        cache.resize( 16 );
+    }
+
+    inline double y( double value ) const
+    {
+        return value * scale + offset;
+    }
+
+    QwtCompressedSeriesData::Encoding encoding;
+    int blockSize;
+
+    double x0;
+    double dx;
+    double scale;
+    double offset;
+
+    int size;
+
+    QVector<QwtCompressedSeriesData::Block *> blocks;
+
+    // values of the incomplete last block
+    QVector<double> pending;
+
+    mutable QVector<CacheEntry> cache;
+    mutable quint64 clock;
+    mutable int lastHit;
+};
+
+/*!
+  Constructor
+
+  \param x0 x coordinate of the first sample
+  \param dx Distance between two samples
+  \param encoding Compression of the values
+  \param blockSize Number of values of a compressed block
+*/
+QwtCompressedSeriesData::QwtCompressedSeriesData( 
+    double x0, double dx, Encoding encoding, int blockSize )
+{
+    d_data = new PrivateData;
+    d_data->x0 = x0;
+    d_data->dx = ( dx > 0.0 ) ? dx : 1.0;
+    d_data->encoding = encoding;
+    d_data->blockSize = qMax( blockSize, 16 );
+}
+
+//! Destructor
+QwtCompressedSeriesData::~QwtCompressedSeriesData()
+{
+    qDeleteAll( d_data->blocks );
+    delete d_data;
+}
+
+//! \return Compression of the values
+QwtCompressedSeriesData::Encoding QwtCompressedSeriesData::encoding() const
+{
+    return d_data->encoding;
+}
+
+//! \return Number of values of a compressed block
+int QwtCompressedSeriesData::blockSize() const
+{
+    return d_data->blockSize;
+}
+
+//! \return x coordinate of the first sample
+double QwtCompressedSeriesData::x0() const
+{
+    return d_data->x0;
+}
+
+//! \return Distance between two samples
+double QwtCompressedSeriesData::dx() const
+{
+    return d_data->dx;
+}
+
+/*!
+  Set the transformation of the values into y coordinates:
+  y = value * scale + offset.
+
+  \param scale Scale factor
+  \param offset Offset
+  \sa scale(), offset()
+*/
+void QwtCompressedSeriesData::setScale( double scale, double offset )
+{
+    d_data->scale = scale;
+    d_data->offset = offset;
+}
+
+/*!
+  \return Scale factor of the transformation of the values
+  \sa setScale()
+*/
+double QwtCompressedSeriesData::scale() const
+{
+    return d_data->scale;
+}
+
+/*!
+  \return Offset of the transformation of the values
+  \sa setScale()
+*/
+double QwtCompressedSeriesData::offset() const
+{
+    return d_data->offset;
+}
+
+/*!
+  Set the number of decoded blocks, that are cached
+  \param cacheSize Number of blocks
+  \sa cacheSize()
+*/
+void QwtCompressedSeriesData::setCacheSize( int cacheSize )
+{
+    d_data->cache.resize( qMax( cacheSize, 1 ) );
+    d_data->lastHit = 0;
+}
+
+/*!
+  \return Number of decoded blocks, that are cached
+  \sa setCacheSize()
+*/
+int QwtCompressedSeriesData::cacheSize() const
+{
+    return d_data->cache.size();
+}
+
+/*!
+  Append a value
+
+  \param value Value. For DeltaEncoding it is rounded to an integer.
+  \sa setScale()
+*/
+void QwtCompressedSeriesData::append( double value )
+{
+    if ( d_data->encoding == DeltaEncoding )
+        value = qRound64( value );
+
+    d_data->pending += value;
+    d_data->size++;
+
+    if ( d_data->pending.size() >= d_data->blockSize )
+        compress();
+}
+
+/*!
+  Append values
+
+  \param values Array of values
+  \param size Number of values
+*/
+void QwtCompressedSeriesData::append( const double *values, int size )
+{
+    for ( int i = 0; i < size; i++ )
+        append( values[i] );
+}
+
+//! Remove all samples
+void QwtCompressedSeriesData::clear()
+{
+    qDeleteAll( d_data->blocks );
+    d_data->blocks.clear();
+    d_data->pending.clear();
+    d_data->size = 0;
+
+    for ( int i = 0; i < d_data->cache.size(); i++ )
+        d_data->cache[i].blockIndex = -1;
+}
+
+/*!
+  \return Number of bytes, that are allocated for the compressed blocks
+          and the values of the incomplete last block
+*/
+qint64 QwtCompressedSeriesData::memoryUsage() const
+{
+    qint64 bytes = 0;
+
+    for ( int i = 0; i < d_data->blocks.size(); i++ )
+    {
+        bytes += sizeof( Block ) 
+            + d_data->blocks[i]->words.capacity() * sizeof( quint64 );
+    }
+
+    bytes += d_data->pending.capacity() * sizeof( double );
+
+    return bytes;
+}
+
+//! \return Number of samples
+int QwtCompressedSeriesData::size() const
+{
+    return d_data->size;
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+QPointF QwtCompressedSeriesData::sample( int i ) const
+{
+    return QPointF( d_data->x0 + i * d_data->dx, d_data->y( value( i ) ) );
+}
+
+/*!
+  \return Bounding rectangle, calculated from the block headers
+*/
+QRectF QwtCompressedSeriesData::boundingRect() const
+{
+    double min, max;
+    if ( !yRange( 0, d_data->size - 1, min, max ) )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    const double xMin = d_data->x0;
+    const double xMax = d_data->x0 + ( d_data->size - 1 ) * d_data->dx;
+
+    return QRectF( xMin, min, xMax - xMin, max - min );
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval in O(1)
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return true
+*/
+bool QwtCompressedSeriesData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    const double dx = d_data->dx;
+    const int size = d_data->size;
+
+    const double i1 = qBound( 0.0, ( x1 - d_data->x0 ) / dx, double( size ) );
+    const double i2 = qBound( -1.0, ( x2 - d_data->x0 ) / dx, size - 1.0 );
+
+    from = qCeil( i1 );
+    to = qFloor( i2 );
+
+    return true;
+}
+
+/*!
+  Calculate the minimum and maximum of the y coordinates
+
+  Complete blocks are taken from their headers, only the blocks
+  at the borders of the range are decoded.
+
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param min Minimum of the y coordinates
+  \param max Maximum of the y coordinates
+
+  \return false, when there are no valid values in the range
+*/
+bool QwtCompressedSeriesData::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    from = qMax( from, 0 );
+    to = qMin( to, d_data->size - 1 );
+
+    const int blockSize = d_data->blockSize;
+    const int numBlocks = d_data->blocks.size();
+
+    double lo = DBL_MAX;
+    double hi = -DBL_MAX;
+
+    int i = from;
+    while ( i <= to )
+    {
+        const int blockIndex = i / blockSize;
+
+        if ( blockIndex < numBlocks && i % blockSize == 0 && 
+            i + blockSize - 1 <= to )
+        {
+            const Block *block = d_data->blocks[blockIndex];
+            if ( block->min <= block->max )
+            {
+                // the scale factor might be negative
+                const double y1 = d_data->y( block->min );
+                const double y2 = d_data->y( block->max );
+
+                lo = qMin( lo, qMin( y1, y2 ) );
+                hi = qMax( hi, qMax( y1, y2 ) );
+            }
+
+            i += blockSize;
+        }
+        else
+        {
+            const double y = d_data->y( value( i ) );
+            if ( y < lo )
+                lo = y;
+            if ( y > hi )
+                hi = y;
+
+            i++;
+        }
+    }
+
+    if ( lo > hi )
+        return false;
+
+    min = lo;
+    max = hi;
+
+    return true;
+}
+
+void QwtCompressedSeriesData::compress()
+{
+    const QVector<double> &values = d_data->pending;
+    const int count = values.size();
+
+    if ( count == 0 )
+        return;
+
+    Block *block = new Block();
+    block->count = count;
+
+    for ( int i = 0; i < count; i++ )
+    {
+        if ( values[i] < block->min )
+            block->min = values[i];
+        if ( values[i] > block->max )
+            block->max = values[i];
+    }
+
+    QwtBitWriter writer( block->words );
+
+    if ( d_data->encoding == DeltaEncoding )
+    {
+        // zigzag encoded differences: 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+
+        QVector<quint64> deltas( count - 1 );
+
+        quint64 bits = 0;
+
+        qint64 previous = qint64( values[0] );
+        for ( int i = 1; i < count; i++ )
+        {
+            const qint64 value = qint64( values[i] );
+            const qint64 delta = value - previous;
+
+            deltas[i - 1] = ( quint64( delta ) << 1 ) ^ quint64( delta >> 63 );
+            bits |= deltas[i - 1];
+
+            previous = value;
+        }
+
+        block->first = qint64( values[0] );
+        block->bitWidth = 64 - qwtLeadingZeros( bits );
+
+        for ( int i = 0; i < deltas.size(); i++ )
+            writer.write( deltas[i], block->bitWidth );
+    }
+    else
+    {
+        quint64 previous = qwtBits( values[0] );
+        writer.write( previous, 64 );
+
+        int leading = -1;
+        int trailing = 0;
+
+        for ( int i = 1; i < count; i++ )
+        {
+            const quint64 bits = qwtBits( values[i] );
+            const quint64 x = bits ^ previous;
+
+            if ( x == 0 )
+            {
+                writer.write( 0, 1 );
+            }
+            else
+            {
+                writer.write( 1, 1 );
+
+                const int lz = qMin( qwtLeadingZeros( x ), 31 );
+                const int tz = qwtTrailingZeros( x );
+
+                if ( leading >= 0 && lz >= leading && tz >= trailing )
+                {
+                    // the meaningful bits fit into the previous window
+                    writer.write( 0, 1 );
+                    writer.write( x >> trailing, 64 - leading - trailing );
+                }
+                else
+                {
+                    const int numBits = 64 - lz - tz;
+
+                    writer.write( 1, 1 );
+                    writer.write( lz, 5 );
+                    writer.write( numBits - 1, 6 );
+                    writer.write( x >> tz, numBits );
+
+                    leading = lz;
+                    trailing = tz;
+                }
+            }
+
+            previous = bits;
+        }
+    }
+
+    block->words.squeeze();
+
+    d_data->blocks += block;
+    d_data->pending.resize( 0 );
+}
+
+const double *QwtCompressedSeriesData::decompress( int blockIndex ) const
+{
+    QVector<PrivateData::CacheEntry> &cache = d_data->cache;
+
+    PrivateData::CacheEntry *entry = &cache[d_data->lastHit];
+    if ( entry->blockIndex == blockIndex )
+    {
+        entry->lastUsed = ++d_data->clock;
+        return entry->values.constData();
+    }
+
+    // looking for the block or the least recently used entry
+
+    int lru = 0;
+    for ( int i = 0; i < cache.size(); i++ )
+    {
+        if ( cache[i].blockIndex == blockIndex )
+        {
+            d_data->lastHit = i;
+            cache[i].lastUsed = ++d_data->clock;
+
+            return cache[i].values.constData();
+        }
+
+        if ( cache[i].lastUsed < cache[lru].lastUsed )
+            lru = i;
+    }
+
+    const Block *block = d_data->blocks[blockIndex];
+
+    entry = &cache[lru];
+    entry->blockIndex = blockIndex;
+    entry->lastUsed = ++d_data->clock;
+    entry->values.resize( block->count );
+
+    double *values = entry->values.data();
+
+    QwtBitReader reader( block->words.constData() );
+
+    if ( d_data->encoding == DeltaEncoding )
+    {
+        qint64 value = block->first;
+        values[0] = value;
+
+        for ( int i = 1; i < block->count; i++ )
+        {
+            const quint64 z = reader.read( block->bitWidth );
+            value += qint64( z >> 1 ) ^ -qint64( z & 1 );
+
+            values[i] = value;
+        }
+    }
+    else
+    {
+        quint64 previous = reader.read( 64 );
+        values[0] = qwtDouble( previous );
+
+        int leading = 0;
+        int trailing = 0;
+
+        for ( int i = 1; i < block->count; i++ )
+        {
+            if ( reader.read( 1 ) )
+            {
+                if ( reader.read( 1 ) )
+                {
+                    leading = int( reader.read( 5 ) );
+                    const int numBits = int( reader.read( 6 ) ) + 1;
+                    trailing = 64 - leading - numBits;
+                }
+
+                const quint64 x = reader.read( 64 - leading - trailing );
+                previous ^= x << trailing;
+            }
+
+            values[i] = qwtDouble( previous );
+        }
+    }
+
+    d_data->lastHit = lru;
+    return values;
+}
+
+inline double QwtCompressedSeriesData::value( int index ) const
+{
+    const int blockIndex = index / d_data->blockSize;
+    const int offset = index % d_data->blockSize;
+
+    if ( blockIndex >= d_data->blocks.size() )
+        return d_data->pending[offset];
+
+    return decompress( blockIndex )[offset];
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "qwt_series_data.h"
+
+/*!
+  \brief Series of uniformly sampled values, stored compressed in memory
+
+  The x coordinates are calculated from the position of the first sample
+  and the distance between the samples: x( i ) = x0 + i * dx. The values
+  are appended one by one and collected in blocks, that are compressed,
+  when they are complete:
+
+  - DeltaEncoding: the differences between consecutive values are
+    stored with the minimum number of bits of the block. The values
+    have to be integers, like the output of an ADC.
+
+  - XorEncoding: each double is XOR'ed with its predecessor and only
+    the bits, that differ, are stored ( see "Gorilla: A fast, scalable,
+    in-memory time series database" ). This is lossless for any value.
+
+  For slowly changing signals both encodings need 4-10 times less 
+  memory than an array of doubles.
+
+  Each block has a header with the minimum and maximum of its values.
+  So boundingRect() and yRange() don't need to decode complete blocks
+  and QwtPlotCurve can paint zoomed out views from the headers only.
+  The samples of a block are decoded, when they are accessed, and kept in 
+  a small cache of the most recently used blocks.
+
+  The y coordinates are calculated by: y( i ) = value( i ) * scale + offset.
+
+  \note Decoding modifies the cache, so the series must not be accessed
+         from different threads at the same time.
+*/
+class QwtCompressedSeriesData: public QwtSeriesData<QPointF>
+{
+public:
+    //! Compression of the values
+    enum Encoding
+    {
+        //! Differences of consecutive integers, packed into bits
+        DeltaEncoding,
+
+        //! XOR of consecutive doubles, without leading and trailing zeros
+        XorEncoding
+    };
+
+    explicit QwtCompressedSeriesData( double x0 = 0.0, double dx = 1.0,
+        Encoding = XorEncoding, int blockSize = 1024 );
+
+    virtual ~QwtCompressedSeriesData();
+
+    Encoding encoding() const;
+    int blockSize() const;
+
+    double x0() const;
+    double dx() const;
+
+    void setScale( double scale, double offset = 0.0 );
+    double scale() const;
+    double offset() const;
+
+    void setCacheSize( int );
+    int cacheSize() const;
+
+    void append( double value );
+    void append( const double *values, int size );
+
+    void clear();
+
+    qint64 memoryUsage() const;
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+private:
+    QwtCompressedSeriesData( const QwtCompressedSeriesData & );
+    QwtCompressedSeriesData &operator=( const QwtCompressedSeriesData & );
+
+    class Block;
+
+    void compress();
+    const double *decompress( int blockIndex ) const;
+
+    double value( int index ) const;
+
+    class PrivateData;
+    PrivateData *d_data;
+};
@@ -0,0 +1,822 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_mapped_series_data.h"
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qdatetime.h>
+#include <qvector.h>
+#include <qmath.h>
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const quint32 qwtDataMagic = 0x53545751; // "QWTS"
+static const quint32 qwtSummaryMagic = 0x4d545751; // "QWTM"
+static const quint32 qwtVersion = 1;
+
+// samples summarized in a block of the lowest level
+static const int qwtBlockSize = 256;
+
+// blocks of a level summarized in a block of the next level
+static const int qwtFanout = 16;
+
+class QwtMappedHeader
+{
+public:
+    quint32 magic;
+    quint32 version;
+    quint32 dataType;
+    quint32 layout;
+    quint64 count;
+    double x0;
+    double dx;
+    char reserved[24];
+};
+
+class QwtSummaryHeader
+{
+public:
+    quint32 magic;
+    quint32 version;
+    quint32 blockSize;
+    quint32 fanout;
+    quint64 count;
+    qint64 fileSize;
+    qint64 lastModified;
+    quint32 sorted;
+    quint32 reserved;
+    double xMin;
+    double xMax;
+    double yMin;
+    double yMax;
+};
+
+static inline int qwtValueSize( int dataType )
+{
+    switch( dataType )
+    {
+        case QwtMappedSeriesData::Float32:
+        case QwtMappedSeriesData::Int32:
+            return 4;
+        case QwtMappedSeriesData::Int16:
+            return 2;
+        case QwtMappedSeriesData::Float64:
+        default:
+            return 8;
+    }
+}
+
+static inline double qwtValue( const uchar *p, int dataType )
+{
+    switch( dataType )
+    {
+        case QwtMappedSeriesData::Float32:
+            return *reinterpret_cast<const float *>( p );
+        case QwtMappedSeriesData::Int16:
+            return *reinterpret_cast<const qint16 *>( p );
+        case QwtMappedSeriesData::Int32:
+            return *reinterpret_cast<const qint32 *>( p );
+        case QwtMappedSeriesData::Float64:
+        default:
+            return *reinterpret_cast<const double *>( p );
+    }
+}
+
+// number of min/max pairs for each level of the summary
+static QVector<int> qwtLevelSizes( int count )
+{
+    QVector<int> sizes;
+    if ( count <= 0 )
+        return sizes;
+
+    int n = ( count + qwtBlockSize - 1 ) / qwtBlockSize;
+    sizes += n;
+
+    while ( n > 1 )
+    {
+        n = ( n + qwtFanout - 1 ) / qwtFanout;
+        sizes += n;
+    }
+
+    return sizes;
+}
+
+enum QwtAdvice
+{
+    QwtAdviceNormal,
+    QwtAdviceSequential,
+    QwtAdviceWillNeed
+};
+
+static void qwtAdvise( const uchar *data, qint64 length, QwtAdvice advice )
+{
+#if defined(Q_OS_UNIX)
+    if ( data == NULL || length <= 0 )
+        return;
+
+    int flag = MADV_NORMAL;
+    if ( advice == QwtAdviceSequential )
+        flag = MADV_SEQUENTIAL;
+    else if ( advice == QwtAdviceWillNeed )
+        flag = MADV_WILLNEED;
+
+    const qint64 pageSize = sysconf( _SC_PAGESIZE );
+    if ( pageSize <= 0 )
+        return;
+
+    // madvise needs page aligned addresses
+    const quintptr addr = reinterpret_cast<quintptr>( data );
+    const quintptr start = addr - addr % pageSize;
+
+    ::madvise( reinterpret_cast<void *>( start ),
+        size_t( length + ( addr - start ) ), flag );
+#else
+    Q_UNUSED( data );
+    Q_UNUSED( length );
+    Q_UNUSED( advice );
+#endif
+}
+
+class QwtMappedSeriesData::PrivateData
+{
+public:
+    PrivateData():
+        data( NULL ),
+        values( NULL ),
+        dataType( QwtMappedSeriesData::Float64 ),
+        layout( QwtMappedSeriesData::Uniform ),
+        count( 0 ),
+        columnSize( 0 ),
+        x0( 0.0 ),
+        dx( 1.0 ),
+        valueSize( 8 ),
+        sorted( false ),
+        boundingRect( 1.0, 1.0, -2.0, -2.0 ),
+        advisedFrom( -1 ),
+        advisedTo( -1 )
+    {
+    }
+
+    QFile file;
+    uchar *data;
+    const uchar *values;
+
+    QwtMappedSeriesData::DataType dataType;
+    QwtMappedSeriesData::Layout layout;
+    int count;
+    qint64 columnSize; // values of the x column of a Planar file
+    double x0;
+    double dx;
+    int valueSize;
+
+    bool sorted;
+    QRectF boundingRect;
+
+    // min/max pairs of the blocks of each level
+    QVector< QVector<double> > levels;
+
+    int advisedFrom;
+    int advisedTo;
+};
+
+/*!
+  Constructor
+
+  Maps the file and loads or calculates its summary.
+  \param fileName Name of the file
+  \sa isValid()
+*/
+QwtMappedSeriesData::QwtMappedSeriesData( const QString &fileName )
+{
+    d_data = new PrivateData;
+    d_data->file.setFileName( fileName );
+
+    if ( open() )
+    {
+        if ( !loadSummary() )
+        {
+            buildSummary();
+            saveSummary();
+        }
+    }
+    else
+    {
+        d_data->file.close();
+        d_data->data = NULL;
+        d_data->values = NULL;
+        d_data->count = 0;
+        d_data->columnSize = 0;
+    }
+}
+
+//! Destructor
+QwtMappedSeriesData::~QwtMappedSeriesData()
+{
+    if ( d_data->data )
+        d_data->file.unmap( d_data->data );
+
+    delete d_data;
+}
+
+/*!
+  \return true, when the file could be mapped and has a valid header
+*/
+bool QwtMappedSeriesData::isValid() const
+{
+    return d_data->values != NULL;
+}
+
+//! \return Name of the file
+QString QwtMappedSeriesData::fileName() const
+{
+    return d_data->file.fileName();
+}
+
+//! \return Type of the values
+QwtMappedSeriesData::DataType QwtMappedSeriesData::dataType() const
+{
+    return d_data->dataType;
+}
+
+//! \return Layout of the values
+QwtMappedSeriesData::Layout QwtMappedSeriesData::layout() const
+{
+    return d_data->layout;
+}
+
+//! \return x coordinate of the first sample for the Uniform layout
+double QwtMappedSeriesData::x0() const
+{
+    return d_data->x0;
+}
+
+//! \return Distance between two samples for the Uniform layout
+double QwtMappedSeriesData::dx() const
+{
+    return d_data->dx;
+}
+
+//! \return Number of samples
+int QwtMappedSeriesData::size() const
+{
+    return d_data->count;
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+QPointF QwtMappedSeriesData::sample( int i ) const
+{
+    return QPointF( xValue( i ), yValue( i ) );
+}
+
+/*!
+  \return Bounding rectangle, taken from the summary
+*/
+QRectF QwtMappedSeriesData::boundingRect() const
+{
+    return d_data->boundingRect;
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+
+  For the Uniform layout the range is calculated in O(1), otherwise
+  by a binary search, when the summary found the x coordinates 
+  to be increasing.
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return false, when the x coordinates are not increasing
+*/
+bool QwtMappedSeriesData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( !d_data->sorted )
+        return false;
+
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    const int count = d_data->count;
+
+    if ( d_data->layout == Uniform )
+    {
+        const double dx = d_data->dx;
+
+        const double i1 = qBound( 0.0, ( x1 - d_data->x0 ) / dx, double( count ) );
+        const double i2 = qBound( -1.0, ( x2 - d_data->x0 ) / dx, count - 1.0 );
+
+        from = qCeil( i1 );
+        to = qFloor( i2 );
+
+        return true;
+    }
+
+    int lo = 0;
+    int hi = count;
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( xValue( mid ) < x1 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    from = lo;
+
+    hi = count;
+    while ( lo < hi )
+    {
+        const int mid = lo + ( hi - lo ) / 2;
+        if ( xValue( mid ) <= x2 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    to = lo - 1;
+
+    return true;
+}
+
+/*!
+  Calculate the minimum and maximum of the y coordinates
+
+  Complete blocks are taken from the summary, only the samples at
+  the borders, that don't fill a block, are read from the file.
+
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param min Minimum of the y coordinates
+  \param max Maximum of the y coordinates
+
+  \return false, when there are no valid values in the range
+*/
+bool QwtMappedSeriesData::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    from = qMax( from, 0 );
+    to = qMin( to, d_data->count - 1 );
+
+    const QVector< QVector<double> > &levels = d_data->levels;
+
+    double lo = DBL_MAX;
+    double hi = -DBL_MAX;
+
+    int i = from;
+    while ( i <= to )
+    {
+        // the highest level with a block starting at i and ending before to
+
+        int level = -1;
+        qint64 size = qwtBlockSize;
+
+        while ( level + 1 < levels.size() && 
+            i % size == 0 && i + size - 1 <= to )
+        {
+            level++;
+            size *= qwtFanout;
+        }
+
+        if ( level < 0 )
+        {
+            const double y = yValue( i );
+            if ( y < lo )
+                lo = y;
+            if ( y > hi )
+                hi = y;
+
+            i++;
+        }
+        else
+        {
+            const qint64 blockSize = size / qwtFanout;
+            const int block = int( i / blockSize );
+
+            const double *minMax = levels[level].constData() + 2 * block;
+            if ( minMax[0] < lo )
+                lo = minMax[0];
+            if ( minMax[1] > hi )
+                hi = minMax[1];
+
+            i += int( blockSize );
+        }
+    }
+
+    if ( lo > hi )
+        return false;
+
+    min = lo;
+    max = hi;
+
+    return true;
+}
+
+/*!
+  Tell the operating system, which samples will be needed
+  
+  When the visible samples are not too many, they are prefetched
+  ( madvise( MADV_WILLNEED ) ). Larger ranges are painted from 
+  the summary and only a few pages are read.
+
+  \param rect Visible rectangle in plot coordinates
+*/
+void QwtMappedSeriesData::setRectOfInterest( const QRectF &rect )
+{
+#if defined(Q_OS_UNIX)
+    int from, to;
+    if ( !indexRange( rect.left(), rect.right(), from, to ) || from > to )
+        return;
+
+    if ( from == d_data->advisedFrom && to == d_data->advisedTo )
+        return;
+
+    d_data->advisedFrom = from;
+    d_data->advisedTo = to;
+
+    const int valuesPerSample = ( d_data->layout == Uniform ) ? 1 : 2;
+    const qint64 length = qint64( to - from + 1 ) * d_data->valueSize;
+
+    if ( length * valuesPerSample > 64 * 1024 * 1024 )
+        return;
+
+    const uchar *values = d_data->values;
+    const int vs = d_data->valueSize;
+
+    switch( d_data->layout )
+    {
+        case Uniform:
+            qwtAdvise( values + qint64( from ) * vs, length, QwtAdviceWillNeed );
+            break;
+        case Interleaved:
+            qwtAdvise( values + 2 * qint64( from ) * vs, 
+                2 * length, QwtAdviceWillNeed );
+            break;
+        case Planar:
+            qwtAdvise( values + qint64( from ) * vs, length, QwtAdviceWillNeed );
+            qwtAdvise( values + ( d_data->columnSize + from ) * vs, 
+                length, QwtAdviceWillNeed );
+            break;
+    }
+#else
+    Q_UNUSED( rect );
+#endif
+}
+
+//! \return Size of the header of a file
+int QwtMappedSeriesData::headerSize()
+{
+    return sizeof( QwtMappedHeader );
+}
+
+/*!
+  Write the header of a file
+
+  The values have to be written after the header in the layout
+  and type, that is described by it.
+
+  \param device Device, where to write the header
+  \param dataType Type of the values
+  \param layout Layout of the values
+  \param count Number of samples
+  \param x0 x coordinate of the first sample for the Uniform layout
+  \param dx Distance between two samples for the Uniform layout
+
+  \return true, when the header has been written completely
+*/
+bool QwtMappedSeriesData::writeHeader( QIODevice *device,
+    DataType dataType, Layout layout, qint64 count, double x0, double dx )
+{
+    if ( device == NULL )
+        return false;
+
+    QwtMappedHeader header;
+    memset( &header, 0, sizeof( header ) );
+
+    header.magic = qwtDataMagic;
+    header.version = qwtVersion;
+    header.dataType = dataType;
+    header.layout = layout;
+    header.count = quint64( qMax( count, qint64( 0 ) ) );
+    header.x0 = x0;
+    header.dx = dx;
+
+    return device->write( reinterpret_cast<const char *>( &header ),
+        sizeof( header ) ) == qint64( sizeof( header ) );
+}
+
+bool QwtMappedSeriesData::open()
+{
+    QFile &file = d_data->file;
+
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    const qint64 fileSize = file.size();
+    if ( fileSize < qint64( sizeof( QwtMappedHeader ) ) )
+        return false;
+
+    uchar *data = file.map( 0, fileSize );
+    if ( data == NULL )
+        return false;
+
+    d_data->data = data;
+
+    QwtMappedHeader header;
+    memcpy( &header, data, sizeof( header ) );
+
+    if ( header.magic != qwtDataMagic || header.version != qwtVersion ||
+        header.dataType > Int32 || header.layout > Planar )
+    {
+        return false;
+    }
+
+    d_data->dataType = static_cast<DataType>( header.dataType );
+    d_data->layout = static_cast<Layout>( header.layout );
+    d_data->valueSize = qwtValueSize( d_data->dataType );
+    d_data->x0 = header.x0;
+    d_data->dx = header.dx;
+
+    if ( d_data->layout == Uniform && !( d_data->dx > 0.0 ) )
+        return false;
+
+    const int valuesPerSample = ( d_data->layout == Uniform ) ? 1 : 2;
+
+    const quint64 maxCount = quint64( fileSize - sizeof( header ) ) 
+        / ( valuesPerSample * d_data->valueSize );
+
+    if ( header.count > maxCount )
+        return false;
+
+    /*
+      Samples beyond INT_MAX can't be addressed, but the y column
+      of a Planar file starts behind all x values of the file.
+     */
+    d_data->count = int( qMin( header.count, quint64( INT_MAX ) ) );
+    d_data->columnSize = qint64( header.count );
+    d_data->values = data + sizeof( header );
+
+    return true;
+}
+
+bool QwtMappedSeriesData::loadSummary()
+{
+    QFile file( fileName() + ".summary" );
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    QwtSummaryHeader header;
+    if ( file.read( reinterpret_cast<char *>( &header ), sizeof( header ) )
+        != qint64( sizeof( header ) ) )
+    {
+        return false;
+    }
+
+    const QFileInfo info( d_data->file );
+
+    // the summary is invalid, when the recording has been modified
+
+    if ( header.magic != qwtSummaryMagic || header.version != qwtVersion ||
+        header.blockSize != quint32( qwtBlockSize ) || 
+        header.fanout != quint32( qwtFanout ) ||
+        header.count != quint64( d_data->count ) ||
+        header.fileSize != info.size() ||
+        header.lastModified != info.lastModified().toMSecsSinceEpoch() )
+    {
+        return false;
+    }
+
+    const QVector<int> sizes = qwtLevelSizes( d_data->count );
+
+    QVector< QVector<double> > levels( sizes.size() );
+    for ( int i = 0; i < sizes.size(); i++ )
+    {
+        levels[i].resize( 2 * sizes[i] );
+
+        const qint64 length = levels[i].size() * sizeof( double );
+        if ( file.read( reinterpret_cast<char *>( levels[i].data() ), 
+            length ) != length )
+        {
+            return false;
+        }
+    }
+
+    d_data->levels = levels;
+    d_data->sorted = ( d_data->layout == Uniform ) || header.sorted;
+
+    if ( header.xMin <= header.xMax && header.yMin <= header.yMax )
+    {
+        d_data->boundingRect.setCoords( 
+            header.xMin, header.yMin, header.xMax, header.yMax );
+    }
+
+    return true;
+}
+
+void QwtMappedSeriesData::buildSummary()
+{
+    const int count = d_data->count;
+
+    const qint64 length = qint64( count ) 
+        * d_data->valueSize * ( d_data->layout == Uniform ? 1 : 2 );
+
+    // all pages are read once
+    qwtAdvise( d_data->values, length, QwtAdviceSequential );
+
+    const QVector<int> sizes = qwtLevelSizes( count );
+    QVector< QVector<double> > levels( sizes.size() );
+
+    if ( sizes.size() > 0 )
+    {
+        QVector<double> &level = levels[0];
+        level.resize( 2 * sizes[0] );
+
+        for ( int block = 0; block < sizes[0]; block++ )
+        {
+            double lo = DBL_MAX;
+            double hi = -DBL_MAX;
+
+            const int from = block * qwtBlockSize;
+            const int to = qMin( from + qwtBlockSize, count );
+
+            for ( int i = from; i < to; i++ )
+            {
+                const double y = yValue( i );
+                if ( y < lo )
+                    lo = y;
+                if ( y > hi )
+                    hi = y;
+            }
+
+            level[2 * block] = lo;
+            level[2 * block + 1] = hi;
+        }
+    }
+
+    for ( int l = 1; l < sizes.size(); l++ )
+    {
+        const QVector<double> &lower = levels[l - 1];
+
+        QVector<double> &level = levels[l];
+        level.resize( 2 * sizes[l] );
+
+        for ( int block = 0; block < sizes[l]; block++ )
+        {
+            double lo = DBL_MAX;
+            double hi = -DBL_MAX;
+
+            const int from = block * qwtFanout;
+            const int to = qMin( from + qwtFanout, sizes[l - 1] );
+
+            for ( int i = from; i < to; i++ )
+            {
+                lo = qMin( lo, lower[2 * i] );
+                hi = qMax( hi, lower[2 * i + 1] );
+            }
+
+            level[2 * block] = lo;
+            level[2 * block + 1] = hi;
+        }
+    }
+
+    d_data->levels = levels;
+
+    double xMin = DBL_MAX;
+    double xMax = -DBL_MAX;
+
+    if ( d_data->layout == Uniform )
+    {
+        d_data->sorted = true;
+
+        if ( count > 0 )
+        {
+            xMin = d_data->x0;
+            xMax = d_data->x0 + ( count - 1 ) * d_data->dx;
+        }
+    }
+    else
+    {
+        bool sorted = true;
+
+        for ( int i = 0; i < count; i++ )
+        {
+            const double x = xValue( i );
+
+            if ( sorted && i > 0 && !( x >= xValue( i - 1 ) ) )
+                sorted = false;
+
+            if ( x < xMin )
+                xMin = x;
+            if ( x > xMax )
+                xMax = x;
+        }
+
+        d_data->sorted = sorted;
+    }
+
+    if ( !levels.isEmpty() )
+    {
+        const double *minMax = levels.last().constData();
+        if ( xMin <= xMax && minMax[0] <= minMax[1] )
+            d_data->boundingRect.setCoords( xMin, minMax[0], xMax, minMax[1] );
+    }
+
+    qwtAdvise( d_data->values, length, QwtAdviceNormal );
+}
+
+void QwtMappedSeriesData::saveSummary() const
+{
+    QFile file( fileName() + ".summary" );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+        return; // the summary stays in memory only
+
+    const QFileInfo info( d_data->file );
+    const QRectF &rect = d_data->boundingRect;
+
+    QwtSummaryHeader header;
+    memset( &header, 0, sizeof( header ) );
+
+    header.magic = qwtSummaryMagic;
+    header.version = qwtVersion;
+    header.blockSize = qwtBlockSize;
+    header.fanout = qwtFanout;
+    header.count = d_data->count;
+    header.fileSize = info.size();
+    header.lastModified = info.lastModified().toMSecsSinceEpoch();
+    header.sorted = d_data->sorted ? 1 : 0;
+    header.xMin = rect.left();
+    header.xMax = rect.right();
+    header.yMin = rect.top();
+    header.yMax = rect.bottom();
+
+    bool ok = file.write( reinterpret_cast<const char *>( &header ), 
+        sizeof( header ) ) == qint64( sizeof( header ) );
+
+    for ( int i = 0; ok && i < d_data->levels.size(); i++ )
+    {
+        const QVector<double> &level = d_data->levels[i];
+        const qint64 length = level.size() * sizeof( double );
+
+        ok = file.write( reinterpret_cast<const char *>( level.constData() ),
+            length ) == length;
+    }
+
+    if ( !ok )
+        file.remove();
+}
+
+inline double QwtMappedSeriesData::xValue( int index ) const
+{
+    const int vs = d_data->valueSize;
+
+    switch( d_data->layout )
+    {
+        case Interleaved:
+            return qwtValue( d_data->values + 2 * qint64( index ) * vs, 
+                d_data->dataType );
+        case Planar:
+            return qwtValue( d_data->values + qint64( index ) * vs, 
+                d_data->dataType );
+        case Uniform:
+        default:
+            return d_data->x0 + index * d_data->dx;
+    }
+}
+
+inline double QwtMappedSeriesData::yValue( int index ) const
+{
+    const int vs = d_data->valueSize;
+
+    switch( d_data->layout )
+    {
+        case Interleaved:
+            return qwtValue( d_data->values + ( 2 * qint64( index ) + 1 ) * vs, 
+                d_data->dataType );
+        case Planar:
+            return qwtValue( 
+                d_data->values + ( d_data->columnSize + index ) * vs, 
+                d_data->dataType );
+        case Uniform:
+        default:
+            return qwtValue( d_data->values + qint64( index ) * vs, 
+                d_data->dataType );
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qstring.h>
+
+class QIODevice;
+
+/*!
+  \brief Series data in a memory mapped file
+
+  QwtMappedSeriesData displays recordings, that are larger than
+  the available memory, without reading them. The file is mapped
+  into the address space and the operating system loads only
+  the pages, that are accessed.
+
+  The file starts with a header of 64 bytes ( see writeHeader() ),
+  describing the type of the values, their layout, the number of samples
+  and optionally the parameters of uniformly sampled x coordinates:
+
+  - Uniform: only the y values are stored,
+    x( i ) = x0 + i * dx
+  - Interleaved: x0, y0, x1, y1, ...
+  - Planar: x0, x1, ..., y0, y1, ...
+
+  All numbers are in the byte order of the host.
+
+  When the file is opened the first time a summary with the minima and
+  maxima of blocks of y values is calculated and stored in a sidecar file
+  ( fileName() + ".summary" ). It is used for boundingRect() and yRange(),
+  so that zoomed out views of the curve don't need to load the complete
+  file. When the sidecar can't be written, the summary is only kept
+  in memory.
+
+  \note Only the first INT_MAX samples of larger files are available.
+  \note The x coordinates of interleaved or planar files have to be
+        increasing for indexRange().
+*/
+class QwtMappedSeriesData: public QwtSeriesData<QPointF>
+{
+public:
+    //! Type of the values in the file
+    enum DataType
+    {
+        //! double
+        Float64,
+
+        //! float
+        Float32,
+
+        //! qint16
+        Int16,
+
+        //! qint32
+        Int32
+    };
+
+    //! Arrangement of the values in the file
+    enum Layout
+    {
+        //! y values only, x coordinates are calculated from x0 and dx
+        Uniform,
+
+        //! x and y values alternating
+        Interleaved,
+
+        //! all x values followed by all y values
+        Planar
+    };
+
+    explicit QwtMappedSeriesData( const QString &fileName );
+    virtual ~QwtMappedSeriesData();
+
+    bool isValid() const;
+    QString fileName() const;
+
+    DataType dataType() const;
+    Layout layout() const;
+
+    double x0() const;
+    double dx() const;
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+    virtual void setRectOfInterest( const QRectF & );
+
+    static int headerSize();
+
+    static bool writeHeader( QIODevice *, DataType, Layout, 
+        qint64 count, double x0 = 0.0, double dx = 1.0 );
+
+private:
+    QwtMappedSeriesData( const QwtMappedSeriesData & );
+    QwtMappedSeriesData &operator=( const QwtMappedSeriesData & );
+
+    bool open();
+    bool loadSummary();
+    void buildSummary();
+    void saveSummary() const;
+
+    double xValue( int index ) const;
+    double yValue( int index ) const;
+
+    class PrivateData;
+    PrivateData *d_data;
+};
@@ -0,0 +1,393 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_multichannel_data.h"
+#include "qwt_scale_map.h"
+#include <qalgorithms.h>
+#include <float.h>
+
+class QwtMultiChannelData::PrivateData
+{
+public:
+    PrivateData():
+        sorted( true )
+    {
+        invalidateCache();
+    }
+
+    void invalidateCache()
+    {
+        rangeX1 = rangeX2 = 0.0;
+        rangeFrom = 0;
+        rangeTo = -1;
+        rangeValid = false;
+
+        mapFrom = 0;
+        mapTo = -1;
+        mapValid = false;
+
+        boundingRects.fill( QRectF(), boundingRects.size() );
+        boundingRectsValid.fill( false, boundingRectsValid.size() );
+    }
+
+    QVector<double> xData;
+    QVector< QVector<double> > yData;
+
+    bool sorted;
+
+    // last result of indexRange()
+    double rangeX1;
+    double rangeX2;
+    int rangeFrom;
+    int rangeTo;
+    bool rangeValid;
+
+    // mapped x coordinates of the last scale map
+    double s1, s2, p1, p2;
+    int transformationType;
+    int mapFrom;
+    int mapTo;
+    bool mapValid;
+    QVector<double> mapped;
+
+    QVector<QRectF> boundingRects;
+    QVector<bool> boundingRectsValid;
+};
+
+//! Constructor
+QwtMultiChannelData::QwtMultiChannelData()
+{
+    d_data = new PrivateData;
+}
+
+//! Destructor
+QwtMultiChannelData::~QwtMultiChannelData()
+{
+    delete d_data;
+}
+
+/*!
+  Assign the samples of all channels
+
+  \param xData x coordinates shared by all channels
+  \param yData y coordinates of each channel
+*/
+void QwtMultiChannelData::setSamples( const QVector<double> &xData,
+    const QVector< QVector<double> > &yData )
+{
+    d_data->yData = yData;
+    setXData( xData );
+}
+
+/*!
+  Assign the x coordinates, that are shared by all channels
+  \param xData x coordinates
+*/
+void QwtMultiChannelData::setXData( const QVector<double> &xData )
+{
+    d_data->xData = xData;
+
+    d_data->sorted = true;
+    for ( int i = 1; i < xData.size(); i++ )
+    {
+        if ( !( xData[i] >= xData[i - 1] ) )
+        {
+            d_data->sorted = false;
+            break;
+        }
+    }
+
+    invalidateCache();
+}
+
+/*!
+  Assign the y coordinates of a channel
+
+  \param channel Channel, the number of channels is extended
+                 when necessary
+  \param yData y coordinates
+*/
+void QwtMultiChannelData::setYData( int channel, const QVector<double> &yData )
+{
+    if ( channel < 0 )
+        return;
+
+    if ( channel >= d_data->yData.size() )
+        d_data->yData.resize( channel + 1 );
+
+    d_data->yData[channel] = yData;
+
+    if ( channel < d_data->boundingRectsValid.size() )
+        d_data->boundingRectsValid[channel] = false;
+}
+
+//! \return Number of channels
+int QwtMultiChannelData::channelCount() const
+{
+    return d_data->yData.size();
+}
+
+//! \return Number of x coordinates
+int QwtMultiChannelData::size() const
+{
+    return d_data->xData.size();
+}
+
+//! \return x coordinates shared by all channels
+const QVector<double> &QwtMultiChannelData::xData() const
+{
+    return d_data->xData;
+}
+
+/*!
+  \return y coordinates of a channel
+  \param channel Channel
+*/
+const QVector<double> &QwtMultiChannelData::yData( int channel ) const
+{
+    return d_data->yData[channel];
+}
+
+/*!
+  \return Bounding rectangle of a channel, that is cached until
+          its samples are changed
+  \param channel Channel
+*/
+QRectF QwtMultiChannelData::boundingRect( int channel ) const
+{
+    if ( channel < 0 || channel >= d_data->yData.size() )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    if ( d_data->boundingRects.size() != d_data->yData.size() )
+    {
+        d_data->boundingRects.resize( d_data->yData.size() );
+        d_data->boundingRectsValid.fill( false, d_data->yData.size() );
+    }
+
+    if ( !d_data->boundingRectsValid[channel] )
+    {
+        const QVector<double> &x = d_data->xData;
+        const QVector<double> &y = d_data->yData[channel];
+
+        const int size = qMin( x.size(), y.size() );
+
+        double xMin = DBL_MAX;
+        double xMax = -DBL_MAX;
+        double yMin = DBL_MAX;
+        double yMax = -DBL_MAX;
+
+        for ( int i = 0; i < size; i++ )
+        {
+            if ( x[i] < xMin )
+                xMin = x[i];
+            if ( x[i] > xMax )
+                xMax = x[i];
+
+            if ( y[i] < yMin )
+                yMin = y[i];
+            if ( y[i] > yMax )
+                yMax = y[i];
+        }
+
+        QRectF rect( 1.0, 1.0, -2.0, -2.0 ); // invalid
+        if ( xMin <= xMax && yMin <= yMax )
+            rect.setCoords( xMin, yMin, xMax, yMax );
+
+        d_data->boundingRects[channel] = rect;
+        d_data->boundingRectsValid[channel] = true;
+    }
+
+    return d_data->boundingRects[channel];
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+
+  The result is cached, so that all channels painted with the same
+  scale map share one binary search.
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return false, when the x coordinates are not increasing
+*/
+bool QwtMultiChannelData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( !d_data->sorted )
+        return false;
+
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    PrivateData *d = d_data;
+
+    if ( !( d->rangeValid && x1 == d->rangeX1 && x2 == d->rangeX2 ) )
+    {
+        const double *x = d->xData.constData();
+        const int size = d->xData.size();
+
+        d->rangeFrom = qLowerBound( x, x + size, x1 ) - x;
+        d->rangeTo = int( qUpperBound( x, x + size, x2 ) - x ) - 1;
+        d->rangeX1 = x1;
+        d->rangeX2 = x2;
+        d->rangeValid = true;
+    }
+
+    from = d->rangeFrom;
+    to = d->rangeTo;
+
+    return true;
+}
+
+/*!
+  \brief Map the x coordinates of a range of samples
+
+  The mapped coordinates are cached, so that the x coordinates are 
+  mapped only once for all channels painted with the same scale map.
+
+  \param xMap Maps x-values into pixel coordinates.
+  \param from Index of the first sample
+  \param to Index of the last sample
+
+  \return Mapped x coordinates of the samples from-to. The array is
+          valid until the next call with another scale map or range.
+  \sa QwtSeriesData::transformedX()
+*/
+const double *QwtMultiChannelData::transformedX( 
+    const QwtScaleMap &xMap, int from, int to ) const
+{
+    PrivateData *d = d_data;
+
+    if ( from < 0 || to >= d->xData.size() || from > to )
+        return NULL;
+
+    const int transformationType = xMap.transformation()->type();
+
+    const bool valid = d->mapValid && from >= d->mapFrom && to <= d->mapTo &&
+        xMap.s1() == d->s1 && xMap.s2() == d->s2 &&
+        xMap.p1() == d->p1 && xMap.p2() == d->p2 &&
+        transformationType == d->transformationType;
+
+    if ( !valid )
+    {
+        d->mapped.resize( to - from + 1 );
+
+        const double *x = d->xData.constData() + from;
+        double *mapped = d->mapped.data();
+
+        for ( int i = 0; i < d->mapped.size(); i++ )
+            mapped[i] = xMap.transform( x[i] );
+
+        d->s1 = xMap.s1();
+        d->s2 = xMap.s2();
+        d->p1 = xMap.p1();
+        d->p2 = xMap.p2();
+        d->transformationType = transformationType;
+        d->mapFrom = from;
+        d->mapTo = to;
+        d->mapValid = true;
+    }
+
+    return d->mapped.constData() + ( from - d->mapFrom );
+}
+
+/*!
+  Create a series for a channel
+
+  \param channel Channel
+  \return Series, that refers to the block. The curve, that it
+          is assigned to, takes ownership of it.
+*/
+QwtSeriesData<QPointF> *QwtMultiChannelData::channelData( int channel ) const
+{
+    return new QwtChannelSeriesData( this, channel );
+}
+
+void QwtMultiChannelData::invalidateCache()
+{
+    d_data->invalidateCache();
+}
+
+/*!
+  Constructor
+
+  \param block Block of channels
+  \param channel Channel
+*/
+QwtChannelSeriesData::QwtChannelSeriesData(
+        const QwtMultiChannelData *block, int channel ):
+    d_block( block ),
+    d_channel( channel )
+{
+}
+
+//! \return Block of channels
+const QwtMultiChannelData *QwtChannelSeriesData::block() const
+{
+    return d_block;
+}
+
+//! \return Channel
+int QwtChannelSeriesData::channel() const
+{
+    return d_channel;
+}
+
+//! \return Number of samples of the channel
+int QwtChannelSeriesData::size() const
+{
+    if ( d_channel < 0 || d_channel >= d_block->channelCount() )
+        return 0;
+
+    return qMin( d_block->size(), d_block->yData( d_channel ).size() );
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+QPointF QwtChannelSeriesData::sample( int i ) const
+{
+    return QPointF( d_block->xData()[i], d_block->yData( d_channel )[i] );
+}
+
+//! \return Bounding rectangle of the channel
+QRectF QwtChannelSeriesData::boundingRect() const
+{
+    return d_block->boundingRect( d_channel );
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+  \sa QwtMultiChannelData::indexRange()
+*/
+bool QwtChannelSeriesData::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( !d_block->indexRange( x1, x2, from, to ) )
+        return false;
+
+    to = qMin( to, size() - 1 );
+    return true;
+}
+
+/*!
+  Map the x coordinates of a range of samples
+  \sa QwtMultiChannelData::transformedX()
+*/
+const double *QwtChannelSeriesData::transformedX( 
+    const QwtScaleMap &xMap, int from, int to ) const
+{
+    return d_block->transformedX( xMap, from, to );
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qvector.h>
+
+class QwtScaleMap;
+
+/*!
+  \brief Samples of many channels sharing their x coordinates
+
+  QwtMultiChannelData stores one array of x coordinates and an array
+  of y coordinates for each channel. For each channel a series
+  can be created by channelData(), that is assigned to a curve.
+
+  All curves of a block share the results of the lookup of the visible
+  samples and of the mapping of the x coordinates, that are cached
+  for the current scale map. So painting 256 channels maps the
+  x coordinates only once.
+
+  \par Example
+  \verbatim
+QwtMultiChannelData *block = new QwtMultiChannelData();
+block->setSamples( timestamps, channels );
+
+for ( int i = 0; i < block->channelCount(); i++ )
+{
+    QwtPlotCurve *curve = new QwtPlotCurve();
+    curve->setData( block->channelData( i ) );
+    curve->attach( plot );
+}
+\endverbatim
+
+  \note The block has to stay alive as long as series created
+        by channelData() are in use.
+  \note The mapped x coordinates are only shared by curves with the
+        QwtPlotCurve::Lines style. Other styles and symbols map
+        the x coordinate of each sample on their own.
+  \note The caches are not protected against concurrent access. All
+        curves of a block have to be painted from the same thread,
+        f.e. the GUI thread or the thread rendering a QwtPlotScene.
+*/
+class QwtMultiChannelData
+{
+public:
+    QwtMultiChannelData();
+    virtual ~QwtMultiChannelData();
+
+    void setSamples( const QVector<double> &xData,
+        const QVector< QVector<double> > &yData );
+
+    void setXData( const QVector<double> &xData );
+    void setYData( int channel, const QVector<double> &yData );
+
+    int channelCount() const;
+    int size() const;
+
+    const QVector<double> &xData() const;
+    const QVector<double> &yData( int channel ) const;
+
+    QRectF boundingRect( int channel ) const;
+
+    bool indexRange( double x1, double x2, int &from, int &to ) const;
+    const double *transformedX( const QwtScaleMap &, int from, int to ) const;
+
+    QwtSeriesData<QPointF> *channelData( int channel ) const;
+
+private:
+    QwtMultiChannelData( const QwtMultiChannelData & );
+    QwtMultiChannelData &operator=( const QwtMultiChannelData & );
+
+    void invalidateCache();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+/*!
+  \brief Series of one channel of a QwtMultiChannelData block
+  \sa QwtMultiChannelData::channelData()
+*/
+class QwtChannelSeriesData: public QwtSeriesData<QPointF>
+{
+public:
+    QwtChannelSeriesData( const QwtMultiChannelData *, int channel );
+
+    const QwtMultiChannelData *block() const;
+    int channel() const;
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+
+    virtual const double *transformedX( 
+        const QwtScaleMap &, int from, int to ) const;
+
+private:
+    const QwtMultiChannelData *d_block;
+    int d_channel;
+};
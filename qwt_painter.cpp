@@ -15,10 +15,10 @@
 #include <qpainter.h>
 #include <qpaintdevice.h>
 #include <qpixmap.h>
+#include <qimage.h>
+#include <qcoreapplication.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
-#include <qapplication.h>
-#include <qdesktopwidget.h>
 
 
 void QwtPainter::unscaleFont( QPainter *painter )
@@ -26,28 +26,48 @@ void QwtPainter::unscaleFont( QPainter *painter )
     if ( painter->font().pixelSize() >= 0 )
         return;
 
-    static QSize screenResolution;
-    if ( !screenResolution.isValid() )
-    {
-        QDesktopWidget *desktop = QApplication::desktop();
-        if ( desktop )
-        {
-            screenResolution.setWidth( desktop->logicalDpiX() );
-            screenResolution.setHeight( desktop->logicalDpiY() );
-        }
-    }
+    const QPaintDevice *screen = screenDevice();
 
     const QPaintDevice *pd = painter->device();
-    if ( pd->logicalDpiX() != screenResolution.width() ||
-        pd->logicalDpiY() != screenResolution.height() )
+    if ( pd->logicalDpiX() != screen->logicalDpiX() ||
+        pd->logicalDpiY() != screen->logicalDpiY() )
     {
-        QFont pixelFont( painter->font(), QApplication::desktop() );
+        QFont pixelFont( painter->font(), screenDevice() );
         pixelFont.setPixelSize( QFontInfo( pixelFont ).pixelSize() );
 
         painter->setFont( pixelFont );
     }
 }
 
+/*!
+  \return A paint device with the logical resolution of the screen
+
+  Font metrics for layout calculations are done in screen metrics.
+  Contrary to QApplication::desktop() the device is no widget and
+  can be used from any thread, f.e. when rendering to a QImage
+  in a worker thread.
+
+  \note Before the application object has been created the resolution
+        of the screen is unknown and a device with the default
+        resolution of Qt is returned.
+*/
+QPaintDevice *QwtPainter::screenDevice()
+{
+    /*
+      The default resolution of a QImage is the one of the screen,
+      but it is not known before the application has been created.
+     */
+    if ( QCoreApplication::instance() == NULL )
+    {
+        static QImage defaultDevice( 1, 1, 
+            QImage::Format_ARGB32_Premultiplied );
+        return &defaultDevice;
+    }
+
+    static QImage device( 1, 1, QImage::Format_ARGB32_Premultiplied );
+    return &device;
+}
+
 //! Wrapper for QPainter::drawImage()
 void QwtPainter::drawImage( QPainter *painter,
     const QRectF &rect, const QImage &image )
@@ -4,6 +4,7 @@
 #include <qrect.h>
 
 class QPainter;
+class QPaintDevice;
 class QWidget;
 class QRectF;
 class QImage;
@@ -22,6 +23,8 @@ class QwtPainter
 public:
     static void unscaleFont( QPainter *painter );
 
+    static QPaintDevice *screenDevice();
+
     static void drawImage( QPainter *, const QRectF &, const QImage & );
 
     static void drawFocusRect( QPainter *, QWidget *, const QRect & );
@@ -283,6 +283,7 @@ void QwtPlot::replot()
      */
     QApplication::sendPostedEvents( this, QEvent::LayoutRequest );
 
+    d_data->canvas->invalidateBackingStore();
     d_data->canvas->update();
 }
 
@@ -10,23 +10,118 @@
 #include "qwt_plot_canvas.h"
 #include "qwt_plot.h"
 #include <qpainter.h>
+#include <qimage.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
 #include <qevent.h>
 
+class QwtPlotCanvas::PrivateData
+{
+public:
+    PrivateData():
+        paintAttributes( 0 ),
+        backingStore( NULL )
+    {
+    }
+
+    ~PrivateData()
+    {
+        delete backingStore;
+    }
 
-//! Sets a cross cursor
+    QwtPlotCanvas::PaintAttributes paintAttributes;
+    QImage *backingStore;
+};
+
+//! Sets a cross cursor, enables QwtPlotCanvas::BackingStore
 
 QwtPlotCanvas::QwtPlotCanvas( QwtPlot *plot ):
     QFrame( plot )
 {
+    d_data = new PrivateData;
+
 #ifndef QT_NO_CURSOR
     setCursor( Qt::CrossCursor );
 #endif
 
     setAttribute( Qt::WA_OpaquePaintEvent, true );
+    setPaintAttribute( QwtPlotCanvas::BackingStore, true );
+}
+
+//! Destructor
+QwtPlotCanvas::~QwtPlotCanvas()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Changing the paint attributes
+
+  \param attribute Paint attribute
+  \param on On/Off
+
+  \sa testPaintAttribute(), backingStore()
+*/
+void QwtPlotCanvas::setPaintAttribute( PaintAttribute attribute, bool on )
+{
+    if ( bool( d_data->paintAttributes & attribute ) == on )
+        return;
+
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+
+    if ( attribute == BackingStore )
+    {
+        invalidateBackingStore();
+        update();
+    }
+}
+
+/*!
+  Test wether a paint attribute is enabled
+
+  \param attribute Paint attribute
+  \return true if the attribute is enabled
+  \sa setPaintAttribute()
+*/
+bool QwtPlotCanvas::testPaintAttribute( PaintAttribute attribute ) const
+{
+    return d_data->paintAttributes & attribute;
+}
+
+/*!
+  \return Backing store, might be NULL, when the canvas
+          has not been painted since the last replot or resize
+  \sa invalidateBackingStore(), QwtPlotDirectPainter
+*/
+QImage *QwtPlotCanvas::backingStore()
+{
+    return d_data->backingStore;
 }
 
+/*!
+  \return Backing store, might be NULL, when the canvas
+          has not been painted since the last replot or resize
+  \sa invalidateBackingStore()
+*/
+const QImage *QwtPlotCanvas::backingStore() const
+{
+    return d_data->backingStore;
+}
+
+/*!
+  Invalidate the backing store, so that it is rebuilt
+  from the plot items by the next paint event.
+
+  \sa QwtPlot::replot()
+*/
+void QwtPlotCanvas::invalidateBackingStore()
+{
+    delete d_data->backingStore;
+    d_data->backingStore = NULL;
+}
 
 static inline void qwtDrawStyledBackground(
     QWidget *w, QPainter *painter )
@@ -42,29 +137,101 @@ static inline void qwtDrawStyledBackground(
 */
 void QwtPlotCanvas::paintEvent( QPaintEvent *event )
 {
-    QPainter painter( this );
-    painter.setClipRegion( event->region() );
+    if ( testPaintAttribute( BackingStore ) )
+    {
+#if QT_VERSION >= 0x050100
+        if ( d_data->backingStore && 
+            d_data->backingStore->devicePixelRatio() != devicePixelRatio() )
+        {
+            // moved to a screen with a different resolution
+            invalidateBackingStore();
+        }
+#endif
+        if ( d_data->backingStore == NULL )
+        {
+#if QT_VERSION >= 0x050100
+            const qreal pixelRatio = devicePixelRatio();
+            d_data->backingStore = new QImage( size() * pixelRatio,
+                QImage::Format_ARGB32_Premultiplied );
+            d_data->backingStore->setDevicePixelRatio( pixelRatio );
+#else
+            d_data->backingStore = new QImage( size(),
+                QImage::Format_ARGB32_Premultiplied );
+#endif
+            d_data->backingStore->fill( 0 );
+
+            QPainter painter( d_data->backingStore );
+            drawCanvas( &painter );
+        }
+
+        QPainter painter( this );
+        painter.setClipRegion( event->region() );
+        painter.drawImage( 0, 0, *d_data->backingStore );
+    }
+    else
+    {
+        QPainter painter( this );
+        painter.setClipRegion( event->region() );
+
+        drawCanvas( &painter );
+    }
+}
 
-    painter.save();
+/*!
+  Resize event, invalidating the backing store
+  \param event Resize event
+*/
+void QwtPlotCanvas::resizeEvent( QResizeEvent *event )
+{
+    invalidateBackingStore();
+    QFrame::resizeEvent( event );
+}
+
+/*!
+  Change event, invalidating the backing store, when
+  the palette or the style has been changed
+
+  \param event Change event
+*/
+void QwtPlotCanvas::changeEvent( QEvent *event )
+{
+    switch( event->type() )
+    {
+        case QEvent::PaletteChange:
+        case QEvent::StyleChange:
+        {
+            invalidateBackingStore();
+            break;
+        }
+        default:
+            break;
+    }
+
+    QFrame::changeEvent( event );
+}
+
+void QwtPlotCanvas::drawCanvas( QPainter *painter )
+{
+    painter->save();
 
-    painter.setPen( Qt::NoPen );
-    painter.setBrush( palette().brush( backgroundRole() ) );
-    painter.drawRect( contentsRect() );
+    painter->setPen( Qt::NoPen );
+    painter->setBrush( palette().brush( backgroundRole() ) );
+    painter->drawRect( contentsRect() );
 
     if ( testAttribute( Qt::WA_StyledBackground ) )
-        qwtDrawStyledBackground( this, &painter );
+        qwtDrawStyledBackground( this, painter );
 
-    painter.restore();
+    painter->restore();
 
-    painter.save();
+    painter->save();
 
-    painter.setClipRect( contentsRect(), Qt::IntersectClip );
+    painter->setClipRect( contentsRect(), Qt::IntersectClip );
 
     QwtPlot *plot = qobject_cast<QwtPlot *>( parentWidget() );
-    plot->drawCanvas( &painter );
+    plot->drawCanvas( painter );
 
-    painter.restore();
+    painter->restore();
 
     if ( !testAttribute(Qt::WA_StyledBackground ) && frameWidth() > 0 )
-        drawFrame( &painter );
+        drawFrame( painter );
 }
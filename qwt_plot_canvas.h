@@ -3,6 +3,7 @@
 #include <qframe.h>
 
 class QwtPlot;
+class QImage;
 
 /*!
   \brief Canvas of a QwtPlot.
@@ -13,8 +14,49 @@ class QwtPlotCanvas : public QFrame
     Q_OBJECT
 
 public:
-    QwtPlotCanvas( QwtPlot * );
+    /*!
+      \brief Paint attributes
+
+      The default setting enables BackingStore
+
+      \sa setPaintAttribute(), testPaintAttribute(), backingStore()
+     */
+    enum PaintAttribute
+    {
+        /*!
+          Paint the canvas into an image, that is kept until the next
+          replot, resize or change of the palette, style or device
+          pixel ratio. Paint events only copy the dirty region
+          from the image and QwtPlotDirectPainter draws incremental
+          updates into it.
+         */
+        BackingStore = 1
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
+    explicit QwtPlotCanvas( QwtPlot * );
+    virtual ~QwtPlotCanvas();
+
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
+    QImage *backingStore();
+    const QImage *backingStore() const;
+
+    void invalidateBackingStore();
 
 protected:
     virtual void paintEvent( QPaintEvent * );
+    virtual void resizeEvent( QResizeEvent * );
+    virtual void changeEvent( QEvent * );
+
+private:
+    void drawCanvas( QPainter * );
+
+    class PrivateData;
+    PrivateData *d_data;
 };
+
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotCanvas::PaintAttributes )
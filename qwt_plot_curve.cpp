@@ -14,24 +14,1288 @@
 #include "qwt_plot.h"
 #include "qwt_plot_canvas.h"
 #include "qwt_symbol.h"
+#include "qwt_pixel_matrix.h"
+#include "qwt_color_map.h"
+#include "qwt_interval.h"
+#include "qwt_painter.h"
 #include <qpainter.h>
+#include <qpaintengine.h>
 #include <qpixmap.h>
+#include <qimage.h>
 #include <qalgorithms.h>
 #include <qmath.h>
+#include <qnumeric.h>
+#include <float.h>
+#include <qthread.h>
+#include <qthreadstorage.h>
+#include <qcoreapplication.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+static int verifyRange( int size, int &i1, int &i2 )
+{
+    if ( size < 1 )
+        return 0;
+
+    i1 = qBound( 0, i1, size - 1 );
+    i2 = qBound( 0, i2, size - 1 );
+
+    if ( i1 > i2 )
+        qSwap( i1, i2 );
+
+    return ( i2 - i1 + 1 );
+}
+
+template <typename T>
+static inline void qwtTrim( QVector<T> &buffer, qint64 maxBytes )
+{
+    if ( qint64( buffer.capacity() ) * qint64( sizeof( T ) ) > maxBytes )
+        buffer = QVector<T>();
+}
+
+/*
+  Scratch buffers for painting curves. They are shared by all curves
+  painted in the same thread and keep their capacity, so that painting
+  doesn't allocate memory, once they have grown to their working size.
+  Buffers above a high-water mark are released after each paint
+  operation, with a lower mark for threads other than the GUI thread.
+ */
+class QwtPlotCurveBuffers
+{
+public:
+    QwtPlotCurveBuffers():
+        pixelMatrix( QRect() )
+    {
+    }
+
+    void trim()
+    {
+        const QCoreApplication *app = QCoreApplication::instance();
+        const bool isGuiThread = 
+            app && app->thread() == QThread::currentThread();
+
+        const qint64 maxBytes = isGuiThread ? 16 * 1024 * 1024 : 1024 * 1024;
+
+        qwtTrim( polygon, maxBytes );
+        qwtTrim( chunk, maxBytes );
+        qwtTrim( samples, maxBytes );
+        qwtTrim( lines, maxBytes );
+
+        if ( pixelMatrix.size() / 8 > maxBytes )
+            pixelMatrix = QwtPixelMatrix( QRect() );
+
+        qwtTrim( spanMins, maxBytes );
+        qwtTrim( spanMaxs, maxBytes );
+
+        qwtTrim( counts, maxBytes );
+        for ( int i = 0; i < threadCounts.size(); i++ )
+            qwtTrim( threadCounts[i], maxBytes );
+
+        qwtTrim( colorTable, maxBytes );
+
+        if ( image.byteCount() > maxBytes )
+            image = QImage();
+    }
+
+    QPolygonF polygon;
+    QPolygonF chunk;
+    QPolygonF samples;
+    QVector<QLineF> lines;
+    QwtPixelMatrix pixelMatrix;
+
+    QVector<double> spanMins;
+    QVector<double> spanMaxs;
+
+    QVector<quint32> counts;
+    QVector< QVector<quint32> > threadCounts;
+    QVector<QRgb> colorTable;
+    QImage image;
+};
+
+static QThreadStorage<QwtPlotCurveBuffers *> qwtCurveBuffers;
+
+static QwtPlotCurveBuffers &qwtBuffers()
+{
+    if ( !qwtCurveBuffers.hasLocalData() )
+        qwtCurveBuffers.setLocalData( new QwtPlotCurveBuffers() );
+
+    return *qwtCurveBuffers.localData();
+}
+
+template <typename T>
+static inline T *qwtResize( QVector<T> &buffer, int size )
+{
+    // reserving the capacity prevents Qt 4 from shrinking the buffer
+    buffer.reserve( qMax( size, buffer.capacity() ) );
+    buffer.resize( size );
+
+    return buffer.data();
+}
+
+static inline QRectF qwtCanvasArea(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap )
+{
+    return QRectF( QPointF( xMap.p1(), yMap.p1() ),
+        QPointF( xMap.p2(), yMap.p2() ) ).normalized();
+}
+
+static inline int qwtPixel( double value )
+{
+    // NaNs end up at INT_MAX
+    return qFloor( qBound<double>( -INT_MAX, value, INT_MAX ) );
+}
+
+/*
+  The canvas area extended by a margin, so that lines between 
+  points outside of it can't be visible because of the width of the pen.
+ */
+static QRectF qwtClipRect( const QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap )
+{
+    const QPen pen = painter->pen();
+
+    double margin = 2.0 * qMax( pen.widthF(), 1.0 ) + 1.0;
+    if ( pen.isCosmetic() )
+    {
+        const QTransform transform = painter->deviceTransform();
+
+        const double scale = qSqrt( qAbs( transform.determinant() ) );
+        if ( scale > 0.0 )
+            margin /= scale;
+    }
+
+    return qwtCanvasArea( xMap, yMap ).adjusted(
+        -margin, -margin, margin, margin );
+}
+
+/*
+  Liang-Barsky line clipping: p1 and p2 are moved to the borders
+  of the rectangle. Returns false, when the line is completely outside.
+ */
+static bool qwtClipLine( const QRectF &rect, QPointF &p1, QPointF &p2 )
+{
+    const double x0 = p1.x();
+    const double y0 = p1.y();
+    const double dx = p2.x() - x0;
+    const double dy = p2.y() - y0;
+
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { x0 - rect.left(), rect.right() - x0,
+        y0 - rect.top(), rect.bottom() - y0 };
+
+    double t0 = 0.0;
+    double t1 = 1.0;
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        if ( p[i] == 0.0 )
+        {
+            // parallel to the border
+            if ( q[i] < 0.0 )
+                return false;
+        }
+        else
+        {
+            const double t = q[i] / p[i];
+            if ( p[i] < 0.0 )
+            {
+                if ( t > t1 )
+                    return false;
+
+                if ( t > t0 )
+                    t0 = t;
+            }
+            else
+            {
+                if ( t < t0 )
+                    return false;
+
+                if ( t < t1 )
+                    t1 = t;
+            }
+        }
+    }
+
+    if ( t1 < 1.0 )
+        p2 = QPointF( x0 + t1 * dx, y0 + t1 * dy );
+
+    if ( t0 > 0.0 )
+        p1 = QPointF( x0 + t0 * dx, y0 + t0 * dy );
+
+    return true;
+}
+
+/*
+  Returns the image and the rectangle of device pixels, where painting
+  is allowed, when the painter paints without any effects onto a 32 bit 
+  raster image, so that opaque pixels can be written directly into
+  its scanlines. Otherwise NULL is returned.
+ */
+static QImage *qwtRasterImage( const QPainter *painter, QRect &clipRect )
+{
+    const QPaintEngine *engine = painter->paintEngine();
+    if ( engine == NULL || engine->type() != QPaintEngine::Raster )
+        return NULL;
+
+    QPaintDevice *device = painter->device();
+    if ( device == NULL || device->devType() != QInternal::Image )
+        return NULL;
+
+    QImage *image = static_cast<QImage *>( device );
+    if ( image->format() != QImage::Format_RGB32 &&
+        image->format() != QImage::Format_ARGB32 &&
+        image->format() != QImage::Format_ARGB32_Premultiplied )
+    {
+        return NULL;
+    }
+
+    if ( painter->testRenderHint( QPainter::Antialiasing ) ||
+        painter->compositionMode() != QPainter::CompositionMode_SourceOver ||
+        painter->opacity() < 1.0 )
+    {
+        return NULL;
+    }
+
+    const QTransform transform = painter->deviceTransform();
+    if ( transform.type() > QTransform::TxScale )
+        return NULL;
+
+    clipRect = image->rect();
+
+    if ( painter->hasClipping() )
+    {
+        const QRegion clipRegion = painter->clipRegion();
+        if ( clipRegion.rects().count() > 1 )
+            return NULL;
+
+        clipRect &= transform.mapRect( clipRegion.boundingRect() );
+    }
+
+    return image;
+}
+
+/*
+  Dots painted with a solid, opaque pen of 1 pixel on a raster
+  image can be written directly into its scanlines, what is
+  significantly faster than QPainter::drawPoints(). 
+ */
+static QImage *qwtDotsImage( const QPainter *painter, QRect &clipRect )
+{
+    const QPen pen = painter->pen();
+    if ( pen.style() == Qt::NoPen || 
+        pen.brush().style() != Qt::SolidPattern || 
+        pen.color().alpha() != 255 )
+    {
+        return NULL;
+    }
+
+    if ( pen.widthF() > 1.0 || ( pen.widthF() > 0.0 && !pen.isCosmetic() &&
+        painter->deviceTransform().type() > QTransform::TxTranslate ) )
+    {
+        return NULL;
+    }
+
+    return qwtRasterImage( painter, clipRect );
+}
+
+/*
+  Filling a polygon, that is a function of x ( or y for horizontal
+  curves ) and much denser than the pixels, by vertical spans 
+  between the baseline and the minimum/maximum of the polygon 
+  in each pixel column. Returns false, when the polygon is not
+  suitable and has to be filled by QPainter::drawPolygon().
+ */
+static bool qwtFillSpans( QPainter *painter, const QPolygonF &polygon,
+    Qt::Orientation orientation, double baseline, 
+    const QRectF &area, const QBrush &brush, QwtPlotCurveBuffers &buffers )
+{
+    const bool vertical = ( orientation == Qt::Vertical );
+
+    QRect clipRect;
+    QImage *image = NULL;
+    if ( brush.style() == Qt::SolidPattern && brush.color().alpha() == 255 )
+        image = qwtRasterImage( painter, clipRect );
+
+    const QTransform transform = 
+        image ? painter->deviceTransform() : painter->transform();
+
+    if ( transform.type() > QTransform::TxScale || !transform.isInvertible() )
+        return false;
+
+    QRectF rect = transform.mapRect( area );
+    if ( image )
+        rect &= QRectF( clipRect );
+
+    const int c1 = qFloor( vertical ? rect.left() : rect.top() );
+    const int c2 = qCeil( vertical ? rect.right() : rect.bottom() ) - 1;
+    const double v1 = vertical ? rect.top() : rect.left();
+    const double v2 = vertical ? rect.bottom() : rect.right();
+
+    const int numColumns = c2 - c1 + 1;
+    if ( numColumns <= 0 || v2 <= v1 )
+        return true; // nothing visible
+
+    if ( polygon.size() < 4 * numColumns )
+        return false; // not dense enough
+
+    // p: position along the baseline, v: value
+
+    const double mp = vertical ? transform.m11() : transform.m22();
+    const double dp = vertical ? transform.dx() : transform.dy();
+    const double mv = vertical ? transform.m22() : transform.m11();
+    const double dv = vertical ? transform.dy() : transform.dx();
+
+    double *mins = qwtResize( buffers.spanMins, numColumns );
+    double *maxs = qwtResize( buffers.spanMaxs, numColumns );
+
+    for ( int i = 0; i < numColumns; i++ )
+    {
+        mins[i] = DBL_MAX;
+        maxs[i] = -DBL_MAX;
+    }
+
+    const QPointF *points = polygon.constData();
+
+    double p0 = mp * ( vertical ? points[0].x() : points[0].y() ) + dp;
+    double v0 = mv * ( vertical ? points[0].y() : points[0].x() ) + dv;
+
+    int direction = 0;
+
+    for ( int i = 1; i < polygon.size(); i++ )
+    {
+        const double p = mp * ( vertical ? points[i].x() : points[i].y() ) + dp;
+        const double v = mv * ( vertical ? points[i].y() : points[i].x() ) + dv;
+
+        if ( !( qIsFinite( p ) && qIsFinite( v ) ) )
+            return false;
+
+        if ( p != p0 )
+        {
+            // the polygon has to be a function of p
+
+            const int dir = ( p > p0 ) ? 1 : -1;
+            if ( direction == 0 )
+                direction = dir;
+            else if ( dir != direction )
+                return false;
+        }
+
+        const double lo = qMin( p0, p );
+        const double hi = qMax( p0, p );
+
+        const int from = qMax( c1, qwtPixel( lo ) );
+        const int to = qMin( c2, qwtPixel( hi ) );
+
+        for ( int c = from; c <= to; c++ )
+        {
+            // values of the segment inside of the column
+
+            double va = v0;
+            double vb = v;
+
+            if ( hi > lo )
+            {
+                const double s = ( v - v0 ) / ( p - p0 );
+                va = v0 + ( qMax( lo, double( c ) ) - p0 ) * s;
+                vb = v0 + ( qMin( hi, c + 1.0 ) - p0 ) * s;
+            }
+
+            const int col = c - c1;
+            mins[col] = qMin( mins[col], qMin( va, vb ) );
+            maxs[col] = qMax( maxs[col], qMax( va, vb ) );
+        }
+
+        p0 = p;
+        v0 = v;
+    }
+
+    const double base = mv * baseline + dv;
+
+    if ( image )
+    {
+        const QRgb rgb = brush.color().rgba();
+
+        uchar *bits = image->bits();
+        const int bytesPerLine = image->bytesPerLine();
+
+        for ( int col = 0; col < numColumns; col++ )
+        {
+            if ( mins[col] > maxs[col] )
+                continue;
+
+            // pixels with their center inside of the span
+
+            const int from = qRound( qBound( v1, qMin( base, mins[col] ), v2 ) );
+            const int to = qRound( qBound( v1, qMax( base, maxs[col] ), v2 ) ) - 1;
+
+            const int c = c1 + col;
+
+            if ( vertical )
+            {
+                for ( int row = from; row <= to; row++ )
+                    reinterpret_cast<QRgb *>( bits + row * bytesPerLine )[c] = rgb;
+            }
+            else
+            {
+                QRgb *line = reinterpret_cast<QRgb *>( bits + c * bytesPerLine );
+                for ( int x = from; x <= to; x++ )
+                    line[x] = rgb;
+            }
+        }
+
+        return true;
+    }
+
+    /*
+      Without direct access to the pixels the spans are
+      painted as a band with 4 points per column.
+     */
+    const QTransform invTransform = transform.inverted();
+
+    QPolygonF &band = buffers.chunk;
+
+    int col = 0;
+    while ( col < numColumns )
+    {
+        if ( mins[col] > maxs[col] )
+        {
+            col++;
+            continue;
+        }
+
+        // a range of consecutive columns with spans
+
+        int last = col;
+        while ( last + 1 < numColumns && mins[last + 1] <= maxs[last + 1] )
+            last++;
+
+        QPointF *bandPoints = qwtResize( band, 4 * ( last - col + 1 ) );
+
+        int n = 0;
+        for ( int i = col; i <= last; i++ )
+        {
+            const double v = qBound( v1, qMin( base, mins[i] ), v2 );
+            const double c = c1 + i;
+
+            bandPoints[n++] = vertical ? QPointF( c, v ) : QPointF( v, c );
+            bandPoints[n++] = vertical ? QPointF( c + 1, v ) : QPointF( v, c + 1 );
+        }
+
+        for ( int i = last; i >= col; i-- )
+        {
+            const double v = qBound( v1, qMax( base, maxs[i] ), v2 );
+            const double c = c1 + i;
+
+            bandPoints[n++] = vertical ? QPointF( c + 1, v ) : QPointF( v, c + 1 );
+            bandPoints[n++] = vertical ? QPointF( c, v ) : QPointF( v, c );
+        }
+
+        for ( int i = 0; i < n; i++ )
+            bandPoints[i] = invTransform.map( bandPoints[i] );
+
+        painter->drawPolygon( bandPoints, n );
+
+        col = last + 1;
+    }
+
+    return true;
+}
+
+static double qwtBaseline( const QwtScaleMap &map, double baseline )
+{
+    if ( map.transformation()->type() == QwtScaleTransformation::Log10 )
+    {
+        if ( baseline < QwtScaleMap::LogMin )
+            baseline = QwtScaleMap::LogMin;
+    }
+
+    return map.transform( baseline );
+}
+
+/*
+  Reduce the samples to the first, the minimum, the maximum and the last
+  sample of each pixel column ( M4 ). The result is in plot coordinates
+  and paints the same pixels as the complete series.
+
+  This is only possible for series, that can find the samples of a
+  column and their y range without iterating over them.
+ */
+static bool qwtDecimate( const QwtSeriesData<QPointF> *series,
+    const QwtScaleMap &xMap, int from, int to, QPolygonF &samples )
+{
+    const double p1 = qFloor( qMin( xMap.p1(), xMap.p2() ) );
+    const double p2 = qCeil( qMax( xMap.p1(), xMap.p2() ) );
+
+    const int numColumns = int( p2 - p1 );
+    if ( numColumns <= 0 || to - from + 1 <= 4 * numColumns )
+        return false;
+
+    int i1, i2;
+    double min, max;
+
+    if ( !series->indexRange( xMap.s1(), xMap.s2(), i1, i2 ) ||
+        !series->yRange( from, from, min, max ) )
+    {
+        return false;
+    }
+
+    qwtResize( samples, 0 );
+    samples += series->sample( from );
+
+    for ( int c = 0; c < numColumns; c++ )
+    {
+        double x1 = xMap.invTransform( p1 + c );
+        double x2 = xMap.invTransform( p1 + c + 1 );
+        if ( x1 > x2 )
+            qSwap( x1, x2 );
+
+        if ( !series->indexRange( x1, x2, i1, i2 ) )
+            return false;
+
+        i1 = qMax( i1, from );
+        i2 = qMin( i2, to );
+
+        if ( i1 > i2 )
+            continue;
+
+        const QPointF first = series->sample( i1 );
+        samples += first;
+
+        if ( i2 - i1 > 1 && series->yRange( i1, i2, min, max ) )
+        {
+            // the extremum closer to the first sample comes first
+
+            if ( qAbs( first.y() - max ) < qAbs( first.y() - min ) )
+                qSwap( min, max );
+
+            const double x = xMap.invTransform( p1 + c + 0.5 );
+
+            samples += QPointF( x, min );
+            samples += QPointF( x, max );
+        }
+
+        if ( i2 > i1 )
+            samples += series->sample( i2 );
+    }
+
+    samples += series->sample( to );
+
+    return true;
+}
+
+class QwtPolylineSimplifier
+{
+public:
+    /*
+      Streaming simplification of a polyline by "sleeve fitting":
+      a point is only appended to the polygon, when the points since
+      the last appended one can't be replaced by a single line without
+      deviating by more than the tolerance. Needs O(1) memory and
+      one pass over the points.
+     */
+    QwtPolylineSimplifier( double tolerance, QPolygonF &polygon ):
+        d_tolerance( tolerance ),
+        d_polygon( polygon ),
+        d_hasCandidate( false )
+    {
+        reset();
+    }
+
+    void append( const QPointF &pos )
+    {
+        if ( d_polygon.isEmpty() )
+        {
+            d_polygon += pos;
+            d_anchor = pos;
+            return;
+        }
+
+        if ( !accept( pos ) )
+        {
+            // the previous point ends the current line
+
+            d_polygon += d_candidate;
+            d_anchor = d_candidate;
+            reset();
+
+            ( void )accept( pos ); // always succeeds for a new anchor
+        }
+    }
+
+    void flush()
+    {
+        if ( d_hasCandidate )
+        {
+            d_polygon += d_candidate;
+            d_hasCandidate = false;
+        }
+    }
+
+private:
+    void reset()
+    {
+        d_hasDirection = false;
+        d_direction = 0.0;
+        d_minAngle = -M_PI;
+        d_maxAngle = M_PI;
+        d_maxDistance = 0.0;
+    }
+
+    bool accept( const QPointF &pos )
+    {
+        const double dx = pos.x() - d_anchor.x();
+        const double dy = pos.y() - d_anchor.y();
+        const double distance = qSqrt( dx * dx + dy * dy );
+
+        /*
+          Once a point has left the tolerance around the anchor, all
+          following points have to move on. Otherwise a spike returning
+          towards the anchor would be lost. Only the points before the
+          first excursion are accepted without any check.
+         */
+        if ( distance < d_maxDistance )
+            return false;
+
+        if ( distance > d_tolerance )
+        {
+            const double angle = qAtan2( dy, dx );
+            if ( !d_hasDirection )
+            {
+                d_direction = angle;
+                d_hasDirection = true;
+            }
+
+            double off = angle - d_direction;
+            if ( off > M_PI )
+                off -= 2 * M_PI;
+            else if ( off < -M_PI )
+                off += 2 * M_PI;
+
+            if ( off < d_minAngle || off > d_maxAngle )
+                return false;
+
+            const double delta = qAsin( d_tolerance / distance );
+
+            d_minAngle = qMax( d_minAngle, off - delta );
+            d_maxAngle = qMin( d_maxAngle, off + delta );
+            d_maxDistance = distance;
+        }
+
+        d_candidate = pos;
+        d_hasCandidate = true;
+
+        return true;
+    }
+
+    const double d_tolerance;
+    QPolygonF &d_polygon;
+
+    QPointF d_anchor;
+    QPointF d_candidate;
+    bool d_hasCandidate;
+
+    bool d_hasDirection;
+    double d_direction;
+    double d_minAngle;
+    double d_maxAngle;
+    double d_maxDistance;
+};
+
+/*
+  Streaming reduction of a polyline, without changing what is visible
+  on the paint device:
+
+  - A run of points, that are all outside of the clip rectangle
+    on the same side, is replaced by its first and last point:
+    the lines between them are invisible anyway.
+
+  - Consecutive points in the same pixel column of the paint device
+    ( row for horizontal curves ) are replaced by the first, the
+    minimum, the maximum and the last of them.
+ */
+class QwtPolylineReducer
+{
+public:
+    QwtPolylineReducer( const QRectF &clipRect, 
+            Qt::Orientation orientation, const QTransform &transform,
+            QPolygonF &polygon ):
+        d_clipRect( clipRect ),
+        d_vertical( orientation == Qt::Vertical ),
+        d_doCollapse( transform.type() <= QTransform::TxScale ),
+        d_m( d_vertical ? transform.m11() : transform.m22() ),
+        d_d( d_vertical ? transform.dx() : transform.dy() ),
+        d_polygon( polygon ),
+        d_runMask( 0 ),
+        d_hasPending( false ),
+        d_hasColumn( false ),
+        d_column( 0 ),
+        d_minFirst( true )
+    {
+    }
+
+    void append( const QPointF &pos )
+    {
+        const int code = outCode( pos );
+
+        if ( d_runMask != 0 )
+        {
+            const int mask = d_runMask & code;
+            if ( mask != 0 )
+            {
+                // still outside on the same side
+                d_runMask = mask;
+                d_pending = pos;
+                d_hasPending = true;
+
+                return;
+            }
+
+            if ( d_hasPending )
+            {
+                collapse( d_pending );
+                d_hasPending = false;
+            }
+        }
+
+        collapse( pos );
+        d_runMask = code;
+    }
+
+    void flush()
+    {
+        if ( d_hasPending )
+        {
+            collapse( d_pending );
+            d_hasPending = false;
+        }
+
+        flushColumn();
+        d_runMask = 0;
+    }
+
+private:
+    enum OutCode
+    {
+        Left = 0x01,
+        Right = 0x02,
+        Top = 0x04,
+        Bottom = 0x08
+    };
+
+    inline int outCode( const QPointF &pos ) const
+    {
+        int code = 0;
+
+        if ( pos.x() < d_clipRect.left() )
+            code |= Left;
+        else if ( pos.x() > d_clipRect.right() )
+            code |= Right;
+
+        if ( pos.y() < d_clipRect.top() )
+            code |= Top;
+        else if ( pos.y() > d_clipRect.bottom() )
+            code |= Bottom;
+
+        return code;
+    }
+
+    inline double value( const QPointF &pos ) const
+    {
+        return d_vertical ? pos.y() : pos.x();
+    }
+
+    void collapse( const QPointF &pos )
+    {
+        if ( !d_doCollapse )
+        {
+            d_polygon += pos;
+            return;
+        }
+
+        const int column = qwtPixel( 
+            d_m * ( d_vertical ? pos.x() : pos.y() ) + d_d );
+
+        if ( d_hasColumn && column == d_column )
+        {
+            if ( value( pos ) < value( d_min ) )
+            {
+                d_min = pos;
+                d_minFirst = false;
+            }
+
+            if ( value( pos ) > value( d_max ) )
+            {
+                d_max = pos;
+                d_minFirst = true;
+            }
+
+            d_last = pos;
+            return;
+        }
+
+        flushColumn();
+
+        d_hasColumn = true;
+        d_column = column;
+        d_minFirst = true;
+        d_first = d_last = d_min = d_max = pos;
+    }
+
+    void flushColumn()
+    {
+        if ( !d_hasColumn )
+            return;
+
+        d_hasColumn = false;
+
+        appendPoint( d_first );
+        appendPoint( d_minFirst ? d_min : d_max );
+        appendPoint( d_minFirst ? d_max : d_min );
+        appendPoint( d_last );
+    }
+
+    inline void appendPoint( const QPointF &pos )
+    {
+        if ( d_polygon.isEmpty() || d_polygon.last() != pos )
+            d_polygon += pos;
+    }
+
+    const QRectF d_clipRect;
+
+    const bool d_vertical;
+    const bool d_doCollapse;
+    const double d_m;
+    const double d_d;
+
+    QPolygonF &d_polygon;
+
+    int d_runMask;
+    QPointF d_pending;
+    bool d_hasPending;
+
+    bool d_hasColumn;
+    int d_column;
+    bool d_minFirst;
+    QPointF d_first;
+    QPointF d_last;
+    QPointF d_min;
+    QPointF d_max;
+};
+
+/*
+  Counting samples per pixel for the QwtPlotCurve::Density style.
+  Different ranges of samples can be binned in parallel threads
+  into separate histograms.
+ */
+class QwtDensityBinner
+{
+public:
+    QwtDensityBinner( const QwtSeriesData<QPointF> *series,
+            const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+            const QRectF &area, const QSize &size ):
+        d_series( series ),
+        d_xMap( xMap ),
+        d_yMap( yMap ),
+        d_x0( area.left() ),
+        d_y0( area.top() ),
+        d_xScale( size.width() / area.width() ),
+        d_yScale( size.height() / area.height() ),
+        d_width( size.width() ),
+        d_height( size.height() )
+    {
+    }
+
+    void bin( int from, int to, quint32 *counts ) const
+    {
+        for ( int i = from; i <= to; i++ )
+        {
+            const QPointF sample = d_series->sample( i );
+
+            const double x = 
+                ( d_xMap.transform( sample.x() ) - d_x0 ) * d_xScale;
+            const double y = 
+                ( d_yMap.transform( sample.y() ) - d_y0 ) * d_yScale;
+
+            // also catches NaNs
+            if ( !( x >= 0.0 && x < d_width && y >= 0.0 && y < d_height ) )
+                continue;
+
+            counts[ int( y ) * d_width + int( x ) ]++;
+        }
+    }
+
+private:
+    const QwtSeriesData<QPointF> *d_series;
+    const QwtScaleMap d_xMap;
+    const QwtScaleMap d_yMap;
+
+    const double d_x0;
+    const double d_y0;
+    const double d_xScale;
+    const double d_yScale;
+
+    const int d_width;
+    const int d_height;
+};
+
+/*
+  Index for finding the closest point of a curve.
+
+  For samples with increasing x coordinates the closest point is found
+  by a binary search and a walk to both sides, until the horizontal 
+  distance exceeds the best distance found so far. Otherwise the samples
+  are sorted into a uniform grid in data space. Cells are checked
+  in rings around the cell of the position, until no cell outside
+  can be closer in widget coordinates.
+
+  The index follows appended samples: they are checked for being sorted
+  and kept outside of the grid, until there are too many of them.
+ */
+class QwtCurveSpatialIndex
+{
+public:
+    QwtCurveSpatialIndex()
+    {
+        invalidate();
+    }
+
+    void invalidate()
+    {
+        d_series = NULL;
+        d_revision = 0;
+        d_size = 0;
+        d_sorted = true;
+        d_lastX = 0.0;
+
+        d_gridSize = 0;
+        d_rect = QRectF();
+        d_columns = d_rows = 0;
+        d_cellWidth = d_cellHeight = 1.0;
+        d_cellStart.clear();
+        d_indexes.clear();
+    }
+
+    void update( const QwtSeriesData<QPointF> *series )
+    {
+        const int size = series->size();
+
+        // f.e. QwtSharedSeriesData replaces its samples in place
+        if ( size < d_size || series->revision() != d_revision )
+            invalidate();
+
+        d_series = series;
+        d_revision = series->revision();
+
+        for ( int i = d_size; i < size; i++ )
+        {
+            const double x = series->sample( i ).x();
+            if ( i > 0 && !( x >= d_lastX ) )
+                d_sorted = false;
+
+            d_lastX = x;
+        }
+
+        d_size = size;
+
+        if ( !d_sorted )
+        {
+            // appended samples are checked one by one, until
+            // there are too many of them
+
+            const int maxPending = qMax( 4096, d_gridSize / 16 );
+            if ( d_columns == 0 || d_size - d_gridSize > maxPending )
+                buildGrid();
+        }
+    }
+
+    int closestPoint( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, double &dmin ) const
+    {
+        int index = -1;
+
+        if ( d_sorted )
+        {
+            searchSorted( xMap, yMap, pos, index, dmin );
+        }
+        else
+        {
+            searchGrid( xMap, yMap, pos, index, dmin );
+
+            for ( int i = d_gridSize; i < d_size; i++ )
+                checkSample( i, xMap, yMap, pos, index, dmin );
+        }
+
+        return index;
+    }
+
+private:
+    inline void checkSample( int i, 
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, int &index, double &dmin ) const
+    {
+        const QPointF sample = d_series->sample( i );
+
+        const double cx = xMap.transform( sample.x() ) - pos.x();
+        const double cy = yMap.transform( sample.y() ) - pos.y();
+
+        const double f = qwtSqr( cx ) + qwtSqr( cy );
+        if ( f < dmin )
+        {
+            index = i;
+            dmin = f;
+        }
+    }
+
+    void searchSorted( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, int &index, double &dmin ) const
+    {
+        const double x = xMap.invTransform( pos.x() );
+
+        int lo = 0;
+        int hi = d_size;
+
+        while ( lo < hi )
+        {
+            const int mid = ( lo + hi ) / 2;
+            if ( d_series->sample( mid ).x() < x )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        for ( int i = lo; i < d_size; i++ )
+        {
+            const double dx = 
+                xMap.transform( d_series->sample( i ).x() ) - pos.x();
+            if ( qwtSqr( dx ) >= dmin )
+                break;
+
+            checkSample( i, xMap, yMap, pos, index, dmin );
+        }
+
+        for ( int i = lo - 1; i >= 0; i-- )
+        {
+            const double dx = 
+                xMap.transform( d_series->sample( i ).x() ) - pos.x();
+            if ( qwtSqr( dx ) >= dmin )
+                break;
+
+            checkSample( i, xMap, yMap, pos, index, dmin );
+        }
+    }
+
+    inline int column( double x ) const
+    {
+        return int( qBound( 0.0, 
+            ( x - d_rect.left() ) / d_cellWidth, d_columns - 1.0 ) );
+    }
+
+    inline int row( double y ) const
+    {
+        return int( qBound( 0.0, 
+            ( y - d_rect.top() ) / d_cellHeight, d_rows - 1.0 ) );
+    }
+
+    void buildGrid()
+    {
+        const int size = d_size;
+
+        double x1 = 0.0;
+        double x2 = -1.0;
+        double y1 = 0.0;
+        double y2 = -1.0;
+
+        for ( int i = 0; i < size; i++ )
+        {
+            const QPointF sample = d_series->sample( i );
+            if ( !( qIsFinite( sample.x() ) && qIsFinite( sample.y() ) ) )
+                continue;
+
+            if ( x1 > x2 )
+            {
+                x1 = x2 = sample.x();
+                y1 = y2 = sample.y();
+            }
+            else
+            {
+                x1 = qMin( x1, sample.x() );
+                x2 = qMax( x2, sample.x() );
+                y1 = qMin( y1, sample.y() );
+                y2 = qMax( y2, sample.y() );
+            }
+        }
 
-static int verifyRange( int size, int &i1, int &i2 )
-{
-    if ( size < 1 )
-        return 0;
+        // about 16 samples per cell
 
-    i1 = qBound( 0, i1, size - 1 );
-    i2 = qBound( 0, i2, size - 1 );
+        const int numCells = qBound( 1, size / 16, 1 << 20 );
 
-    if ( i1 > i2 )
-        qSwap( i1, i2 );
+        d_columns = d_rows = qMax( 1, qCeil( qSqrt( double( numCells ) ) ) );
+        d_rect = QRectF( x1, y1, qMax( x2 - x1, 0.0 ), qMax( y2 - y1, 0.0 ) );
 
-    return ( i2 - i1 + 1 );
-}
+        d_cellWidth = d_rect.width() > 0.0 ? d_rect.width() / d_columns : 1.0;
+        d_cellHeight = d_rect.height() > 0.0 ? d_rect.height() / d_rows : 1.0;
+
+        const int cellCount = d_columns * d_rows;
+
+        QVector<int> cells( size );
+        d_cellStart.fill( 0, cellCount + 1 );
+
+        int numIndexes = 0;
+        for ( int i = 0; i < size; i++ )
+        {
+            const QPointF sample = d_series->sample( i );
+            if ( !( qIsFinite( sample.x() ) && qIsFinite( sample.y() ) ) )
+            {
+                cells[i] = -1;
+                continue;
+            }
+
+            const int cell = row( sample.y() ) * d_columns + column( sample.x() );
+
+            cells[i] = cell;
+            d_cellStart[cell + 1]++;
+            numIndexes++;
+        }
+
+        for ( int i = 0; i < cellCount; i++ )
+            d_cellStart[i + 1] += d_cellStart[i];
+
+        d_indexes.resize( numIndexes );
+
+        QVector<int> offsets = d_cellStart;
+        for ( int i = 0; i < size; i++ )
+        {
+            if ( cells[i] >= 0 )
+                d_indexes[ offsets[ cells[i] ]++ ] = i;
+        }
+
+        d_gridSize = size;
+    }
+
+    void searchCell( int column, int row,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, int &index, double &dmin ) const
+    {
+        const int cell = row * d_columns + column;
+
+        const int from = d_cellStart[cell];
+        const int to = d_cellStart[cell + 1];
+        if ( from == to )
+            return;
+
+        // distance to the cell in widget coordinates
+
+        const double x1 = xMap.transform( d_rect.left() + column * d_cellWidth );
+        const double x2 = xMap.transform( d_rect.left() + ( column + 1 ) * d_cellWidth );
+        const double y1 = yMap.transform( d_rect.top() + row * d_cellHeight );
+        const double y2 = yMap.transform( d_rect.top() + ( row + 1 ) * d_cellHeight );
+
+        double dx = 0.0;
+        if ( pos.x() < qMin( x1, x2 ) )
+            dx = qMin( x1, x2 ) - pos.x();
+        else if ( pos.x() > qMax( x1, x2 ) )
+            dx = pos.x() - qMax( x1, x2 );
+
+        double dy = 0.0;
+        if ( pos.y() < qMin( y1, y2 ) )
+            dy = qMin( y1, y2 ) - pos.y();
+        else if ( pos.y() > qMax( y1, y2 ) )
+            dy = pos.y() - qMax( y1, y2 );
+
+        if ( qwtSqr( dx ) + qwtSqr( dy ) >= dmin )
+            return;
+
+        for ( int i = from; i < to; i++ )
+            checkSample( d_indexes[i], xMap, yMap, pos, index, dmin );
+    }
+
+    void searchGrid( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, int &index, double &dmin ) const
+    {
+        if ( d_columns == 0 )
+            return;
+
+        const int cx = column( xMap.invTransform( pos.x() ) );
+        const int cy = row( yMap.invTransform( pos.y() ) );
+
+        for ( int r = 0; ; r++ )
+        {
+            const int c1 = cx - r;
+            const int c2 = cx + r;
+            const int r1 = cy - r;
+            const int r2 = cy + r;
+
+            for ( int j = qMax( r1, 0 ); j <= qMin( r2, d_rows - 1 ); j++ )
+            {
+                if ( j == r1 || j == r2 )
+                {
+                    for ( int i = qMax( c1, 0 ); i <= qMin( c2, d_columns - 1 ); i++ )
+                        searchCell( i, j, xMap, yMap, pos, index, dmin );
+                }
+                else
+                {
+                    if ( c1 >= 0 )
+                        searchCell( c1, j, xMap, yMap, pos, index, dmin );
+
+                    if ( c2 < d_columns )
+                        searchCell( c2, j, xMap, yMap, pos, index, dmin );
+                }
+            }
+
+            /*
+              All cells outside of the rings are beyond one of the borders,
+              so the distance to the closest border is a lower bound
+             */
+            bool done = true;
+            double bound = 0.0;
+
+            if ( c1 > 0 )
+            {
+                const double x = xMap.transform( d_rect.left() + c1 * d_cellWidth );
+                bound = done ? qAbs( x - pos.x() ) : qMin( bound, qAbs( x - pos.x() ) );
+                done = false;
+            }
+            if ( c2 < d_columns - 1 )
+            {
+                const double x = xMap.transform( d_rect.left() + ( c2 + 1 ) * d_cellWidth );
+                bound = done ? qAbs( x - pos.x() ) : qMin( bound, qAbs( x - pos.x() ) );
+                done = false;
+            }
+            if ( r1 > 0 )
+            {
+                const double y = yMap.transform( d_rect.top() + r1 * d_cellHeight );
+                bound = done ? qAbs( y - pos.y() ) : qMin( bound, qAbs( y - pos.y() ) );
+                done = false;
+            }
+            if ( r2 < d_rows - 1 )
+            {
+                const double y = yMap.transform( d_rect.top() + ( r2 + 1 ) * d_cellHeight );
+                bound = done ? qAbs( y - pos.y() ) : qMin( bound, qAbs( y - pos.y() ) );
+                done = false;
+            }
+
+            if ( done || qwtSqr( bound ) >= dmin )
+                break;
+        }
+    }
+
+    const QwtSeriesData<QPointF> *d_series;
+    uint d_revision;
+    int d_size;
+
+    bool d_sorted;
+    double d_lastX;
+
+    int d_gridSize;
+    QRectF d_rect;
+    int d_columns;
+    int d_rows;
+    double d_cellWidth;
+    double d_cellHeight;
+
+    QVector<int> d_cellStart;
+    QVector<int> d_indexes;
+};
 
 class QwtPlotCurve::PrivateData
 {
@@ -40,15 +1304,22 @@ public:
         style( QwtPlotCurve::Lines ),
         baseline( 0.0 ),
         symbol( NULL ),
+        colorMap( NULL ),
+        renderThreadCount( 1 ),
+        spatialIndex( NULL ),
+        indexedSeries( NULL ),
         attributes( 0 ),
         legendAttributes( 0 )
     {
         pen = QPen( Qt::black );
+        colorMap = new QwtLinearColorMap();
     }
 
     ~PrivateData()
     {
         delete symbol;
+        delete colorMap;
+        delete spatialIndex;
     }
 
     QwtPlotCurve::CurveStyle style;
@@ -56,6 +1327,19 @@ public:
 
     const QwtSymbol *symbol;
 
+    QwtColorMap *colorMap;
+    uint renderThreadCount;
+
+    QwtCurveSpatialIndex *spatialIndex;
+
+    /*
+      The series, that was assigned, when itemChanged() was called
+      last. setData() gets a series, that has been allocated, while
+      the previous one was alive, so both can't have the same address.
+      setSamples() and setRawSamples() invalidate the index explicitly.
+     */
+    const QwtSeriesData<QPointF> *indexedSeries;
+
     QPen pen;
     QBrush brush;
 
@@ -171,6 +1455,66 @@ const QwtSymbol *QwtPlotCurve::symbol() const
     return d_data->symbol;
 }
 
+/*!
+  Change the color map
+
+  The color map is used by the QwtPlotCurve::Density style
+  to map the number of samples per pixel into a color.
+  The default is a QwtLinearColorMap from blue to yellow.
+
+  \param colorMap Color Map
+  \sa colorMap(), setStyle(), QwtPlotCurve::LogDensity
+  \note The curve takes ownership of the color map
+*/
+void QwtPlotCurve::setColorMap( QwtColorMap *colorMap )
+{
+    if ( colorMap != d_data->colorMap )
+    {
+        delete d_data->colorMap;
+        d_data->colorMap = colorMap;
+        itemChanged();
+    }
+}
+
+/*!
+   \return Color Map used for the QwtPlotCurve::Density style
+   \sa setColorMap()
+*/
+const QwtColorMap *QwtPlotCurve::colorMap() const
+{
+    return d_data->colorMap;
+}
+
+/*!
+   Rendering the QwtPlotCurve::Density style can be distributed
+   over several threads, each binning a range of the samples.
+   The data has to support concurrent calls of QwtSeriesData::sample().
+
+   \param numThreads Number of threads to be used for rendering.
+                     If numThreads is set to 0, the system specific
+                     ideal thread count is used.
+
+   The default thread count is 1 ( = no additional threads )
+
+   \sa renderThreadCount(), drawDensity()
+*/
+void QwtPlotCurve::setRenderThreadCount( uint numThreads )
+{
+    d_data->renderThreadCount = numThreads;
+}
+
+/*!
+   \return Number of threads to be used for rendering.
+           If numThreads is set to 0, the system specific
+           ideal thread count is used.
+
+   \sa setRenderThreadCount(), drawDensity()
+*/
+uint QwtPlotCurve::renderThreadCount() const
+{
+    return d_data->renderThreadCount;
+}
+
 /*!
   Assign a pen
 
@@ -228,6 +1572,48 @@ const QBrush& QwtPlotCurve::brush() const
     return d_data->brush;
 }
 
+/*
+  Announces the visible rectangle to the series and restricts
+  from - to to the samples inside of the visible x interval.
+  Returns false, when there is nothing to paint.
+ */
+static bool qwtVisibleRange( QwtSeriesData<QPointF> *series,
+    Qt::Orientation orientation, 
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap, int &from, int &to )
+{
+    /*
+      The series might change its samples in setRectOfInterest(),
+      so it has to be called before looking at its size.
+     */
+    const QRectF rect = QRectF( xMap.s1(), yMap.s1(),
+        xMap.s2() - xMap.s1(), yMap.s2() - yMap.s1() ).normalized();
+    series->setRectOfInterest( rect );
+
+    const int size = series->size();
+    if ( size <= 0 )
+        return false;
+
+    if ( to < 0 )
+        to = size - 1;
+
+    if ( orientation == Qt::Vertical )
+    {
+        /*
+          When the series knows, which samples are inside of the
+          visible interval, we can skip the others. One sample more on
+          each side is needed for lines leaving the canvas.
+         */
+        int i1, i2;
+        if ( series->indexRange( xMap.s1(), xMap.s2(), i1, i2 ) )
+        {
+            from = qMax( from, i1 - 1 );
+            to = qMin( to, i2 + 1 );
+        }
+    }
+
+    return from <= to;
+}
+
 /*!
   Draw an interval of the curve
 
@@ -245,11 +1631,14 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QRectF &canvasRect, int from, int to ) const
 {
-    if ( !painter || dataSize() <= 0 )
+    if ( !painter || d_series == NULL )
         return;
 
-    if ( to < 0 )
-        to = dataSize() - 1;
+    if ( !qwtVisibleRange( d_series, orientation(), 
+        xMap, yMap, from, to ) )
+    {
+        return;
+    }
 
     if ( verifyRange( dataSize(), from, to ) > 0 )
     {
@@ -273,7 +1662,69 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
                 xMap, yMap, canvasRect, from, to );
             painter->restore();
         }
+
+        qwtBuffers().trim();
+    }
+}
+
+/*!
+  \brief Draw the curve with simplified lines
+
+  For the QwtPlotCurve::Lines style the polyline is simplified, so that
+  it deviates by not more than tolerance from the original one.
+  The tolerance is in coordinates of the paint device, what makes the number of
+  painted points depend on the resolution of the target and not on
+  the number of samples. It is intended for vector formats like PDF or SVG,
+  where each point ends up in the document.
+
+  For other styles, or a tolerance <= 0.0, the curve is painted like
+  from draw().
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rect of the canvas
+  \param tolerance Maximum deviation in paint device coordinates
+
+  \sa QwtPlotRenderer::setSimplificationTolerance(), drawLines()
+*/
+void QwtPlotCurve::drawSimplified( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, double tolerance ) const
+{
+    if ( tolerance <= 0.0 || d_data->style != Lines )
+    {
+        draw( painter, xMap, yMap, canvasRect );
+        return;
+    }
+
+    if ( !painter || d_series == NULL )
+        return;
+
+    int from = 0;
+    int to = -1;
+
+    if ( !qwtVisibleRange( d_series, orientation(), 
+        xMap, yMap, from, to ) )
+    {
+        return;
+    }
+
+    painter->save();
+    painter->setPen( d_data->pen );
+    drawLines( painter, xMap, yMap, from, to, tolerance );
+    painter->restore();
+
+    if ( d_data->symbol &&
+        ( d_data->symbol->style() != QwtSymbol::NoSymbol ) )
+    {
+        painter->save();
+        drawSymbols( painter, *d_data->symbol,
+            xMap, yMap, canvasRect, from, to );
+        painter->restore();
     }
+
+    qwtBuffers().trim();
 }
 
 /*!
@@ -305,6 +1756,9 @@ void QwtPlotCurve::drawCurve( QPainter *painter, int style,
         case Dots:
             drawDots( painter, xMap, yMap, from, to );
             break;
+        case Density:
+            drawDensity( painter, xMap, yMap, from, to );
+            break;
         case NoCurve:
         default:
             break;
@@ -320,156 +1774,605 @@ void QwtPlotCurve::drawCurve( QPainter *painter, int style,
   \param painter Painter
   \param xMap x map
   \param yMap y map
-  \param canvasRect Contents rect of the canvas
   \param from index of the first point to be painted
   \param to index of the last point to be painted
-
-  \sa setCurveAttribute(), setCurveFitter(), draw(),
+  \param tolerance When > 0.0 the polyline is simplified, so that it
+                   deviates by not more than tolerance in paint device
+                   coordinates. Otherwise only consecutive points
+                   mapped to the same pixel are skipped, and series
+                   implementing QwtSeriesData::indexRange() and
+                   QwtSeriesData::yRange() are reduced to
+                   4 samples per pixel column.
+
+  \sa setCurveAttribute(), setCurveFitter(), draw(), drawSimplified(),
       drawLines(), drawDots(), drawSteps(), drawSticks()
 */
 #include <qnumeric.h>
 void QwtPlotCurve::drawLines( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    int from, int to ) const
+    int from, int to, double tolerance ) const
 {
     int size = to - from + 1;
     if ( size <= 0 )
         return;
 
-    QPolygonF polyline( size );
-    QPointF *points = polyline.data();
+    QwtPlotCurveBuffers &buffers = qwtBuffers();
+
+    QPolygonF &polyline = buffers.polygon;
+    qwtResize( polyline, 0 );
+
     int new_size = 0;
 
-    int prevx = INT_MAX, prevy = INT_MAX;
-    double dx = 0, dy = 0; //average distance from pixel center
+    if ( tolerance > 0.0 )
+    {
+        // the tolerance is in device coordinates
+
+        const QTransform transform = painter->combinedTransform();
+        const double scale = qSqrt( qAbs( transform.determinant() ) );
+        if ( scale > 0.0 )
+            tolerance /= scale;
 
-    for ( int i = from; i <= to; i++ )
+        QwtPolylineSimplifier simplifier( tolerance, polyline );
+
+        const double *xValues = d_series->transformedX( xMap, from, to );
+
+        for ( int i = from; i <= to; i++ )
+        {
+            const QPointF sample = d_series->sample( i );
+
+            double x = xValues 
+                ? xValues[i - from] : xMap.transform( sample.x() );
+            double y = yMap.transform( sample.y() );
+            x = qBound<double>(-INT_MAX, x, INT_MAX);
+            y = qBound<double>(-INT_MAX, y, INT_MAX);
+
+            simplifier.append( QPointF( x, y ) );
+        }
+        simplifier.flush();
+
+        new_size = polyline.size();
+    }
+    else
     {
-        const QPointF sample = d_series->sample( i );
+        /*
+          When the series has more samples than pixel columns,
+          and offers fast lookups, only 4 samples per column are painted.
+         */
+        const QPointF *decimated = NULL;
+        if ( orientation() == Qt::Vertical &&
+            qwtDecimate( d_series, xMap, from, to, buffers.samples ) )
+        {
+            decimated = buffers.samples.constData();
+            size = buffers.samples.size();
+        }
+
+        /*
+          Series sharing their x coordinates with others might
+          have mapped them already.
+         */
+        const double *xValues = NULL;
+        if ( decimated == NULL )
+            xValues = d_series->transformedX( xMap, from, to );
+
+        QPointF *points = qwtResize( polyline, size );
 
-        double x = xMap.transform( sample.x() );
-        double y = yMap.transform( sample.y() );
-        x = qBound<double>(0, x, INT_MAX);
-        y = qBound<double>(0, y, INT_MAX);
-        int _x = x;
-        int _y = y;
+        int prevx = INT_MAX, prevy = INT_MAX;
+        double dx = 0, dy = 0; //average distance from pixel center
+
+        for ( int i = 0; i < size; i++ )
+        {
+            const QPointF sample = decimated 
+                ? decimated[i] : d_series->sample( from + i );
+
+            double x = xValues ? xValues[i] : xMap.transform( sample.x() );
+            double y = yMap.transform( sample.y() );
+            x = qBound<double>(-INT_MAX, x, INT_MAX);
+            y = qBound<double>(-INT_MAX, y, INT_MAX);
+            int _x = qFloor(x);
+            int _y = qFloor(y);
 #ifndef QWT_CURVE_NO_SKIP
-        if (_x == prevx && _y == prevy)
-            continue;
-        prevx = _x;
-        prevy = _y;
+            if (_x == prevx && _y == prevy)
+                continue;
+            prevx = _x;
+            prevy = _y;
 #endif
-        dx += (x - _x);
-        dy += (y - _y);
+            dx += (x - _x);
+            dy += (y - _y);
 
-        points[new_size].rx() = x;
-        points[new_size].ry() = y;
-        new_size++;
-    }
+            points[new_size].rx() = x;
+            points[new_size].ry() = y;
+            new_size++;
+        }
 
 #ifndef QWT_CURVE_NO_PIXEL_SNAP
-    dx /= new_size;
-    dy /= new_size;
-    double target = painter->pen().widthF() / 2.;
-    target = target - int(target); //0.5 for width 1,3..., 0 for 2,4...
-    for ( int i = 0; i < new_size; i++ )
+        dx /= new_size;
+        dy /= new_size;
+        double target = painter->pen().widthF() / 2.;
+        target = target - int(target); //0.5 for width 1,3..., 0 for 2,4...
+        for ( int i = 0; i < new_size; i++ )
+        {
+            points[i].rx() += (target - dx);
+            points[i].ry() += (-target - dy);
+        }
+#endif
+        polyline.resize( new_size );
+    }
+
+    /*
+      The lines are clipped against the canvas, so that only the
+      visible parts are passed to the paint engine. The polyline itself
+      remains unclipped, as it is needed for filling.
+     */
+    const int chunkSize = 50;
+
+    const QRectF clipRect = qwtClipRect( painter, xMap, yMap );
+    const QPointF *points = polyline.constData();
+
+    QPolygonF &chunk = buffers.chunk;
+    qwtResize( chunk, 0 );
+
+    for ( int i = 1; i < new_size; i++ )
+    {
+        QPointF p1 = points[i - 1];
+        QPointF p2 = points[i];
+
+        const bool visible = ( clipRect.contains( p1 ) 
+            && clipRect.contains( p2 ) ) || qwtClipLine( clipRect, p1, p2 );
+
+        if ( !visible || ( !chunk.isEmpty() && p1 != chunk.last() ) )
+        {
+            // the polyline is interrupted
+
+            if ( chunk.size() > 1 )
+                painter->drawPolyline( chunk.constData(), chunk.size() );
+
+            chunk.resize( 0 );
+
+            if ( !visible )
+                continue;
+        }
+
+        if ( chunk.isEmpty() )
+            chunk += p1;
+
+        chunk += p2;
+
+        if ( chunk.size() >= chunkSize || p2 != points[i] )
+        {
+            painter->drawPolyline( chunk.constData(), chunk.size() );
+            chunk.resize( 0 );
+
+            if ( p2 == points[i] )
+                chunk += p2; // the next chunk continues the polyline
+        }
+    }
+
+    if ( chunk.size() > 1 )
+        painter->drawPolyline( chunk.constData(), chunk.size() );
+
+    if ( d_data->brush.style() != Qt::NoBrush )
+        fillCurve( painter, xMap, yMap, polyline );
+}
+
+/*!
+  Draw sticks
+
+  The sticks are collected in blocks, that are passed to
+  QPainter::drawLines(). Consecutive sticks in the same column
+  ( row for horizontal curves ) of device pixels are merged into one stick
+  from the minimum to the maximum, what makes spectra with millions
+  of peaks paintable at interactive rates.
+
+  \param painter Painter
+  \param xMap x map
+  \param yMap y map
+  \param from index of the first point to be painted
+  \param to index of the last point to be painted
+
+  \sa draw(), drawCurve(), drawDots(), drawLines(), drawSteps()
+*/
+void QwtPlotCurve::drawSticks( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    int from, int to ) const
+{
+    const int chunkSize = 500;
+
+    painter->save();
+    painter->setRenderHint( QPainter::Antialiasing, false );
+
+    const bool vertical = orientation() == Qt::Vertical;
+
+    const double baseline = vertical 
+        ? yMap.transform( d_data->baseline ) 
+        : xMap.transform( d_data->baseline );
+
+    /*
+      Sticks are merged, when they are in the same pixel column
+      of the paint device. As long as the painter doesn't rotate
+      we can find the column from the position alone.
+     */
+    const QTransform transform = painter->deviceTransform();
+    const bool doCollapse = transform.type() <= QTransform::TxScale;
+
+    const double m = vertical ? transform.m11() : transform.m22();
+    const double d = vertical ? transform.dx() : transform.dy();
+
+    QLineF *sticks = qwtResize( qwtBuffers().lines, chunkSize );
+
+    int numSticks = 0;
+
+    bool hasStick = false;
+    int column = 0;
+    double pos = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    for ( int i = from; i <= to; i++ )
     {
-        points[i].rx() += (target - dx);
-        points[i].ry() += (-target - dy);
+        const QPointF sample = d_series->sample( i );
+
+        const double xi = xMap.transform( sample.x() );
+        const double yi = yMap.transform( sample.y() );
+
+        const double p = vertical ? xi : yi;
+        const double v = vertical ? yi : xi;
+
+        const int c = doCollapse ? qwtPixel( m * p + d ) : 0;
+
+        if ( hasStick && doCollapse && c == column )
+        {
+            min = qMin( min, v );
+            max = qMax( max, v );
+            continue;
+        }
+
+        if ( hasStick )
+        {
+            sticks[numSticks++] = vertical 
+                ? QLineF( pos, min, pos, max ) : QLineF( min, pos, max, pos );
+
+            if ( numSticks == chunkSize )
+            {
+                painter->drawLines( sticks, numSticks );
+                numSticks = 0;
+            }
+        }
+
+        hasStick = true;
+        column = c;
+        pos = p;
+        min = qMin( baseline, v );
+        max = qMax( baseline, v );
     }
-#endif
 
-    const int chunkSize = 50;
-    for ( int i = 0; i < new_size-1; i += chunkSize-1 )
+    if ( hasStick )
     {
-        const int n = qMin( chunkSize, new_size - i );
-        painter->drawPolyline( polyline.constData() + i, n );
+        sticks[numSticks++] = vertical 
+            ? QLineF( pos, min, pos, max ) : QLineF( min, pos, max, pos );
     }
 
-    if ( d_data->brush.style() != Qt::NoBrush )
-        fillCurve( painter, xMap, yMap, polyline );
+    if ( numSticks > 0 )
+        painter->drawLines( sticks, numSticks );
+
+    painter->restore();
 }
 
 /*!
-  Draw sticks
+  Draw dots
+
+  The samples are processed in blocks: they are mapped to paint device
+  pixels and only the first dot on each pixel is painted. The remaining
+  dots are passed to QPainter::drawPoints(). When painting to a raster
+  image with a solid 1 pixel pen the pixels are written directly
+  into the scanlines.
 
   \param painter Painter
   \param xMap x map
   \param yMap y map
-  \param canvasRect Contents rect of the canvas
   \param from index of the first point to be painted
   \param to index of the last point to be painted
 
-  \sa draw(), drawCurve(), drawDots(), drawLines(), drawSteps()
+  \sa draw(), drawCurve(), drawSticks(), drawLines(), drawSteps()
 */
-void QwtPlotCurve::drawSticks( QPainter *painter,
+void QwtPlotCurve::drawDots( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     int from, int to ) const
 {
-    painter->save();
-    painter->setRenderHint( QPainter::Antialiasing, false );
+    const int chunkSize = 500;
 
-    double x0 = xMap.transform( d_data->baseline );
-    double y0 = yMap.transform( d_data->baseline );
+    const bool doFill = d_data->brush.style() != Qt::NoBrush;
 
-    const Qt::Orientation o = orientation();
+    const QRectF area = qwtCanvasArea( xMap, yMap );
+    const QTransform transform = painter->deviceTransform();
 
-    for ( int i = from; i <= to; i++ )
+    QRect clipRect;
+    QImage *image = qwtDotsImage( painter, clipRect );
+
+    uchar *bits = NULL;
+    int bytesPerLine = 0;
+    QRgb rgb = 0;
+
+    if ( image )
     {
-        const QPointF sample = d_series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
+        // an image, that is painted, is never shared: bits() doesn't detach
+        bits = image->bits();
+        bytesPerLine = image->bytesPerLine();
+        rgb = painter->pen().color().rgba();
+    }
+
+    QRect pixelRect;
+    if ( image == NULL && transform.type() <= QTransform::TxScale )
+    {
+        pixelRect = transform.mapRect( area ).toAlignedRect();
+        pixelRect.adjust( 0, 0, 1, 1 );
+
+        if ( qint64( pixelRect.width() ) * pixelRect.height() > 0x4000000 )
+            pixelRect = QRect(); // too expensive
+    }
+
+    const bool doDedupe = pixelRect.isValid();
+
+    QwtPlotCurveBuffers &buffers = qwtBuffers();
+
+    QwtPixelMatrix &pixelMatrix = buffers.pixelMatrix;
+    if ( doDedupe )
+        pixelMatrix.setRect( pixelRect );
+
+    QPointF *points = qwtResize( buffers.chunk, chunkSize );
+
+    /*
+      The filled area doesn't change, when dropping consecutive
+      points on the same pixel, so we don't need to keep all of them.
+     */
+    QPolygonF &fillPolygon = buffers.polygon;
+    qwtResize( fillPolygon, 0 );
+    int fillX = INT_MAX;
+    int fillY = INT_MAX;
 
-        if ( o == Qt::Horizontal )
-            painter->drawLine( x0, yi, xi, yi );
+    for ( int i = from; i <= to; i += chunkSize )
+    {
+        const int n = qMin( chunkSize, to - i + 1 );
+
+        for ( int j = 0; j < n; j++ )
+        {
+            const QPointF sample = d_series->sample( i + j );
+
+            points[j].rx() = xMap.transform( sample.x() );
+            points[j].ry() = yMap.transform( sample.y() );
+        }
+
+        if ( doFill )
+        {
+            for ( int j = 0; j < n; j++ )
+            {
+                const QPointF pos = transform.map( points[j] );
+
+                const int px = qwtPixel( pos.x() );
+                const int py = qwtPixel( pos.y() );
+
+                if ( px != fillX || py != fillY )
+                {
+                    fillPolygon += points[j];
+
+                    fillX = px;
+                    fillY = py;
+                }
+            }
+        }
+
+        if ( image )
+        {
+            const double x1 = clipRect.left();
+            const double x2 = clipRect.right() + 1;
+            const double y1 = clipRect.top();
+            const double y2 = clipRect.bottom() + 1;
+
+            for ( int j = 0; j < n; j++ )
+            {
+                const QPointF pos = transform.map( points[j] );
+
+                // also catches NaNs
+                if ( !( pos.x() >= x1 && pos.x() < x2 &&
+                    pos.y() >= y1 && pos.y() < y2 ) )
+                {
+                    continue;
+                }
+
+                QRgb *line = reinterpret_cast<QRgb *>( 
+                    bits + qFloor( pos.y() ) * bytesPerLine );
+                line[ qFloor( pos.x() ) ] = rgb;
+            }
+        }
         else
-            painter->drawLine( xi, y0, xi, yi );
+        {
+            int numPoints = 0;
+
+            for ( int j = 0; j < n; j++ )
+            {
+                const QPointF &point = points[j];
+
+                if ( !area.contains( point ) )
+                    continue;
+
+                if ( doDedupe )
+                {
+                    const QPointF pos = transform.map( point );
+                    if ( pixelMatrix.testAndSetPixel(
+                        qFloor( pos.x() ), qFloor( pos.y() ), true ) )
+                    {
+                        continue;
+                    }
+                }
+
+                points[numPoints++] = point;
+            }
+
+            if ( numPoints > 0 )
+                painter->drawPoints( points, numPoints );
+        }
     }
 
-    painter->restore();
+    if ( doFill )
+        fillCurve( painter, xMap, yMap, fillPolygon );
 }
 
 /*!
-  Draw dots
+  Draw the density of the samples
+
+  The samples are counted per pixel of the canvas, which is given
+  by the paint intervals of the maps. The counts are mapped to colors
+  by the colorMap() - logarithmically when the LogDensity attribute
+  is set - and painted as one image. Pixels without samples
+  remain transparent.
 
   \param painter Painter
   \param xMap x map
   \param yMap y map
-  \param canvasRect Contents rect of the canvas
   \param from index of the first point to be painted
   \param to index of the last point to be painted
 
-  \sa draw(), drawCurve(), drawSticks(), drawLines(), drawSteps()
+  \sa setColorMap(), setRenderThreadCount(), LogDensity
 */
-void QwtPlotCurve::drawDots( QPainter *painter,
+void QwtPlotCurve::drawDensity( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     int from, int to ) const
 {
-    const bool doFill = d_data->brush.style() != Qt::NoBrush;
+    if ( d_data->colorMap == NULL || to < from )
+        return;
 
-    QPolygonF polyline;
-    if ( doFill )
-        polyline.resize( to - from + 1 );
+    const QRectF area = qwtCanvasArea( xMap, yMap );
+    if ( area.isEmpty() )
+        return;
 
-    QPointF *points = polyline.data();
+    // one bin for each pixel of the paint device
 
-    for ( int i = from; i <= to; i++ )
+    QSize imageSize = area.toAlignedRect().size();
+
+    const QTransform transform = painter->deviceTransform();
+    if ( transform.type() <= QTransform::TxScale )
+        imageSize = transform.mapRect( area ).toAlignedRect().size();
+
+    if ( imageSize.isEmpty() )
+        return;
+
+    const int numBins = imageSize.width() * imageSize.height();
+
+    QwtPlotCurveBuffers &buffers = qwtBuffers();
+
+    QVector<quint32> &counts = buffers.counts;
+    qwtResize( counts, numBins );
+    counts.fill( 0 );
+
+    const QwtDensityBinner binner( d_series, xMap, yMap, area, imageSize );
+
+#if !defined(QT_NO_QFUTURE)
+    uint numThreads = d_data->renderThreadCount;
+
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    // not worth to start a thread for less samples
+    const int minSamples = 100000;
+    numThreads = qBound( 1, ( to - from + 1 ) / minSamples, int( numThreads ) );
+
+    const int numSamples = ( to - from + 1 ) / numThreads;
+
+    QVector< QVector<quint32> > &threadCounts = buffers.threadCounts;
+    qwtResize( threadCounts, numThreads - 1 );
+
+    QList< QFuture<void> > futures;
+    for ( uint i = 0; i < numThreads; i++ )
     {
-        const QPointF sample = d_series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
+        const int i1 = from + i * numSamples;
 
-        painter->drawPoint( QPointF( xi, yi ) );
+        if ( i == numThreads - 1 )
+        {
+            binner.bin( i1, to, counts.data() );
+        }
+        else
+        {
+            QVector<quint32> &c = threadCounts[i];
+            qwtResize( c, numBins );
+            c.fill( 0 );
 
-        if ( doFill )
+            futures += QtConcurrent::run( &binner, &QwtDensityBinner::bin,
+                i1, i1 + numSamples - 1, c.data() );
+        }
+    }
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+
+    for ( int i = 0; i < threadCounts.size(); i++ )
+    {
+        quint32 *c = counts.data();
+        const quint32 *tc = threadCounts[i].constData();
+
+        for ( int j = 0; j < numBins; j++ )
+            c[j] += tc[j];
+    }
+#else
+    binner.bin( from, to, counts.data() );
+#endif
+
+    const quint32 *c = counts.constData();
+
+    quint32 maxCount = 0;
+    for ( int i = 0; i < numBins; i++ )
+        maxCount = qMax( maxCount, c[i] );
+
+    if ( maxCount == 0 )
+        return;
+
+    const bool logarithmic = d_data->attributes & LogDensity;
+
+    // [ 0, max ] never collapses to an interval of zero width
+    const QwtInterval interval = logarithmic
+        ? QwtInterval( 0.0, qLn( 1.0 + maxCount ) )
+        : QwtInterval( 0.0, maxCount );
+
+    /*
+      Most bins have low counts: a lookup table avoids
+      calling the color map for each pixel
+     */
+    const quint32 tableSize = qMin( maxCount, quint32( 4096 ) ) + 1;
+
+    QVector<QRgb> &colorTable = buffers.colorTable;
+    qwtResize( colorTable, tableSize );
+
+    colorTable[0] = 0u;
+    for ( quint32 i = 1; i < tableSize; i++ )
+    {
+        const double value = logarithmic ? qLn( 1.0 + i ) : double( i );
+        colorTable[i] = d_data->colorMap->rgb( interval, value );
+    }
+
+    QImage &image = buffers.image;
+    if ( image.size() != imageSize )
+        image = QImage( imageSize, QImage::Format_ARGB32 );
+
+    const QRgb *table = colorTable.constData();
+    for ( int y = 0; y < imageSize.height(); y++ )
+    {
+        QRgb *line = reinterpret_cast<QRgb *>( image.scanLine( y ) );
+        const quint32 *row = c + y * imageSize.width();
+
+        for ( int x = 0; x < imageSize.width(); x++ )
         {
-            points[i - from].rx() = xi;
-            points[i - from].ry() = yi;
+            const quint32 count = row[x];
+            if ( count < tableSize )
+            {
+                line[x] = table[count];
+            }
+            else
+            {
+                const double value = logarithmic 
+                    ? qLn( 1.0 + count ) : double( count );
+                line[x] = d_data->colorMap->rgb( interval, value );
+            }
         }
     }
 
-    if ( doFill )
-        fillCurve( painter, xMap, yMap, polyline );
+    QwtPainter::drawImage( painter, area, image );
 }
 
 /*!
@@ -477,10 +2380,12 @@ void QwtPlotCurve::drawDots( QPainter *painter,
 
   The direction of the steps depends on Inverted attribute.
 
+  Runs of steps outside of the canvas and steps in the same pixel column
+  are reduced, before the polyline is painted in chunks.
+
   \param painter Painter
   \param xMap x map
   \param yMap y map
-  \param canvasRect Contents rect of the canvas
   \param from index of the first point to be painted
   \param to index of the last point to be painted
 
@@ -491,48 +2396,72 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     int from, int to ) const
 {
-    QPolygonF polygon( 2 * ( to - from ) + 1 );
-    QPointF *points = polygon.data();
+    if ( to < from )
+        return;
+
+    const int chunkSize = 50;
+
+    const bool doFill = d_data->brush.style() != Qt::NoBrush;
 
     bool inverted = orientation() == Qt::Vertical;
     if ( d_data->attributes & Inverted )
         inverted = !inverted;
 
-    int i, ip;
-    for ( i = from, ip = 0; i <= to; i++, ip += 2 )
+    const QTransform transform = painter->deviceTransform();
+    const QRectF clipRect = qwtClipRect( painter, xMap, yMap );
+
+    QPolygonF &polygon = qwtBuffers().polygon;
+    qwtResize( polygon, 0 );
+
+    QwtPolylineReducer reducer( clipRect, orientation(), transform, polygon );
+
+    QPointF previous;
+
+    for ( int i = from; i <= to; i++ )
     {
         const QPointF sample = d_series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
 
-        if ( ip > 0 )
-        {
-            const QPointF &p0 = points[ip - 2];
-            QPointF &p = points[ip - 1];
+        const double xi = xMap.transform( sample.x() );
+        const double yi = yMap.transform( sample.y() );
 
+        if ( i > from )
+        {
             if ( inverted )
-            {
-                p.rx() = p0.x();
-                p.ry() = yi;
-            }
+                reducer.append( QPointF( previous.x(), yi ) );
             else
-            {
-                p.rx() = xi;
-                p.ry() = p0.y();
-            }
+                reducer.append( QPointF( xi, previous.y() ) );
         }
 
-        points[ip].rx() = xi;
-        points[ip].ry() = yi;
+        previous.rx() = xi;
+        previous.ry() = yi;
+
+        reducer.append( previous );
+
+        if ( !doFill && polygon.size() >= chunkSize )
+        {
+            // the last point is the first one of the next chunk
+
+            painter->drawPolyline( polygon.constData(), polygon.size() );
+
+            const QPointF last = polygon.last();
+            polygon.resize( 1 );
+            polygon[0] = last;
+        }
     }
 
-    painter->drawPolyline( polygon.constData(), polygon.size() );
+    reducer.flush();
 
-    if ( d_data->brush.style() != Qt::NoBrush )
+    const int size = polygon.size();
+    for ( int i = 0; i < size - 1; i += chunkSize - 1 )
+    {
+        const int n = qMin( chunkSize, size - i );
+        painter->drawPolyline( polygon.constData() + i, n );
+    }
+
+    if ( doFill )
         fillCurve( painter, xMap, yMap, polygon );
 }
 
-
 /*!
   Specify an attribute for drawing the curve
 
@@ -583,10 +2512,6 @@ void QwtPlotCurve::fillCurve( QPainter *painter,
     if ( d_data->brush.style() == Qt::NoBrush )
         return;
 
-    closePolyline( xMap, yMap, polygon );
-    if ( polygon.count() <= 2 ) // a line can't be filled
-        return;
-
     QBrush brush = d_data->brush;
     if ( !brush.color().isValid() )
         brush.setColor( d_data->pen.color() );
@@ -596,7 +2521,22 @@ void QwtPlotCurve::fillCurve( QPainter *painter,
     painter->setPen( Qt::NoPen );
     painter->setBrush( brush );
 
-    painter->drawPolygon( polygon );
+    /*
+      Polygons with many points per pixel are reduced to
+      spans between the baseline and the curve for each pixel column
+     */
+    const Qt::Orientation o = orientation();
+    const double baseline = ( o == Qt::Vertical ) 
+        ? qwtBaseline( yMap, d_data->baseline )
+        : qwtBaseline( xMap, d_data->baseline );
+
+    if ( polygon.size() < 2 || !qwtFillSpans( painter, polygon, o, baseline,
+        qwtCanvasArea( xMap, yMap ), brush, qwtBuffers() ) )
+    {
+        closePolyline( xMap, yMap, polygon );
+        if ( polygon.count() > 2 ) // a line can't be filled
+            painter->drawPolygon( polygon );
+    }
 
     painter->restore();
 }
@@ -617,30 +2557,16 @@ void QwtPlotCurve::closePolyline(
     if ( polygon.size() < 2 )
         return;
 
-    double baseline = d_data->baseline;
-    
     if ( orientation() == Qt::Vertical )
     {
-        if ( yMap.transformation()->type() == QwtScaleTransformation::Log10 )
-        {
-            if ( baseline < QwtScaleMap::LogMin )
-                baseline = QwtScaleMap::LogMin;
-        }
-
-        double refY = yMap.transform( baseline );
+        double refY = qwtBaseline( yMap, d_data->baseline );
 
         polygon += QPointF( polygon.last().x(), refY );
         polygon += QPointF( polygon.first().x(), refY );
     }
     else
     {
-        if ( xMap.transformation()->type() == QwtScaleTransformation::Log10 )
-        {
-            if ( baseline < QwtScaleMap::LogMin )
-                baseline = QwtScaleMap::LogMin;
-        }
-
-        double refX = xMap.transform( baseline );
+        double refX = qwtBaseline( xMap, d_data->baseline );
 
         polygon += QPointF( refX, polygon.last().y() );
         polygon += QPointF( refX, polygon.first().y() );
@@ -650,6 +2576,10 @@ void QwtPlotCurve::closePolyline(
 /*!
   Draw symbols
 
+  Only the first symbol, that is mapped to a pixel of the paint device
+  is painted. Further symbols on the same pixel would cover it
+  ( almost ) completely and are dropped.
+
   \param painter Painter
   \param symbol Curve symbol
   \param xMap x map
@@ -666,25 +2596,67 @@ void QwtPlotCurve::drawSymbols( QPainter *painter, const QwtSymbol &symbol,
 {
     const int chunkSize = 500;
 
-    for ( int i = from; i <= to; i += chunkSize )
+    /*
+      Symbols, that would be painted to a device pixel, where another
+      symbol has already been painted, are dropped. For this
+      we need to know where the paint device pixels are.
+     */
+    const QTransform transform = painter->deviceTransform();
+
+    QRect pixelRect;
+    if ( transform.type() <= QTransform::TxScale )
     {
-        const int n = qMin( chunkSize, to - i + 1 );
+        pixelRect = transform.mapRect( canvasRect ).toAlignedRect();
+        pixelRect.adjust( 0, 0, 1, 1 );
 
-        QPolygonF points;
-        for ( int j = 0; j < n; j++ )
-        {
-            const QPointF sample = d_series->sample( i + j );
+        if ( qint64( pixelRect.width() ) * pixelRect.height() > 0x4000000 )
+            pixelRect = QRect(); // too expensive
+    }
+
+    const bool doDedupe = pixelRect.isValid();
+
+    QwtPlotCurveBuffers &buffers = qwtBuffers();
+
+    QwtPixelMatrix &pixelMatrix = buffers.pixelMatrix;
+    if ( doDedupe )
+        pixelMatrix.setRect( pixelRect );
+
+    QPointF *points = qwtResize( buffers.chunk, chunkSize );
 
-            const double xi = xMap.transform( sample.x() );
-            const double yi = yMap.transform( sample.y() );
+    int numPoints = 0;
 
-            if ( canvasRect.contains( xi, yi ) )
-                points += QPointF( xi, yi );
+    for ( int i = from; i <= to; i++ )
+    {
+        const QPointF sample = d_series->sample( i );
+
+        const double xi = xMap.transform( sample.x() );
+        const double yi = yMap.transform( sample.y() );
+
+        if ( !canvasRect.contains( xi, yi ) )
+            continue;
+
+        if ( doDedupe )
+        {
+            const QPointF pos = transform.map( QPointF( xi, yi ) );
+            if ( pixelMatrix.testAndSetPixel(
+                qFloor( pos.x() ), qFloor( pos.y() ), true ) )
+            {
+                continue;
+            }
         }
 
-        if ( points.size() > 0 )
-            symbol.drawSymbols( painter, points );
+        points[numPoints].rx() = xi;
+        points[numPoints].ry() = yi;
+
+        if ( ++numPoints == chunkSize )
+        {
+            symbol.drawSymbols( painter, points, numPoints );
+            numPoints = 0;
+        }
     }
+
+    if ( numPoints > 0 )
+        symbol.drawSymbols( painter, points, numPoints );
 }
 
 /*!
@@ -728,8 +2700,9 @@ double QwtPlotCurve::baseline() const
               the position and the clostest curve point
   \return Index of the closest curve point, or -1 if none can be found
           ( f.e when the curve has no points )
-  \note closestPoint() implements a dumb algorithm, that iterates
-        over all points
+  \note Without a spatial index closestPoint() implements a dumb 
+        algorithm, that iterates over all points
+  \sa enableSpatialIndex()
 */
 int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
 {
@@ -742,26 +2715,106 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
     int index = -1;
     double dmin = 1.0e10;
 
-    for ( int i = 0; i < dataSize(); i++ )
+    if ( d_data->spatialIndex )
     {
-        const QPointF sample = d_series->sample( i );
+        d_data->spatialIndex->update( d_series );
+        index = d_data->spatialIndex->closestPoint( xMap, yMap, pos, dmin );
+    }
+    else
+    {
+        for ( int i = 0; i < dataSize(); i++ )
+        {
+            const QPointF sample = d_series->sample( i );
 
-        const double cx = xMap.transform( sample.x() ) - pos.x();
-        const double cy = yMap.transform( sample.y() ) - pos.y();
+            const double cx = xMap.transform( sample.x() ) - pos.x();
+            const double cy = yMap.transform( sample.y() ) - pos.y();
 
-        const double f = qwtSqr( cx ) + qwtSqr( cy );
-        if ( f < dmin )
-        {
-            index = i;
-            dmin = f;
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+            if ( f < dmin )
+            {
+                index = i;
+                dmin = f;
+            }
         }
     }
+
     if ( dist )
         *dist = qSqrt( dmin );
 
     return index;
 }
 
+/*!
+  En/Disable a spatial index for closestPoint()
+
+  The index is built, when closestPoint() is called the first time
+  after the samples have been changed. For samples with increasing
+  x coordinates it only needs a binary search, otherwise the samples
+  are sorted into a grid.
+
+  The index is invalidated by itemChanged(), when a new series
+  has been assigned. Samples appended to the series are added
+  to the index, but modifying samples in place can't be detected.
+  In this case invalidateSpatialIndex() has to be called.
+
+  \param on On/Off
+  \sa spatialIndexEnabled(), invalidateSpatialIndex(), closestPoint()
+*/
+void QwtPlotCurve::enableSpatialIndex( bool on )
+{
+    if ( on == ( d_data->spatialIndex != NULL ) )
+        return;
+
+    if ( on )
+    {
+        d_data->spatialIndex = new QwtCurveSpatialIndex();
+    }
+    else
+    {
+        delete d_data->spatialIndex;
+        d_data->spatialIndex = NULL;
+    }
+}
+
+/*!
+  \return True, when closestPoint() uses a spatial index
+  \sa enableSpatialIndex()
+*/
+bool QwtPlotCurve::spatialIndexEnabled() const
+{
+    return d_data->spatialIndex != NULL;
+}
+
+/*!
+  Rebuild the spatial index from scratch, when it is needed next time
+  \sa enableSpatialIndex()
+*/
+void QwtPlotCurve::invalidateSpatialIndex()
+{
+    if ( d_data->spatialIndex )
+        d_data->spatialIndex->invalidate();
+}
+
+/*!
+  Invalidate the spatial index, when the series has been replaced
+  and call QwtPlotItem::itemChanged()
+
+  Changing other attributes like the pen or the title keeps
+  the spatial index.
+
+  \sa invalidateSpatialIndex()
+*/
+void QwtPlotCurve::itemChanged()
+{
+    if ( d_series != d_data->indexedSeries )
+    {
+        d_data->indexedSeries = d_series;
+        invalidateSpatialIndex();
+    }
+
+    QwtPlotSeriesItem<QPointF>::itemChanged();
+}
+
 /*!
    \brief Update the widget that represents the item on the legend
 
@@ -881,6 +2934,7 @@ void QwtPlotCurve::setSamples( const QVector<QPointF> &samples )
 {
     delete d_series;
     d_series = new QwtPointSeriesData( samples );
+    invalidateSpatialIndex();
     itemChanged();
 }
 
@@ -903,6 +2957,31 @@ void QwtPlotCurve::setRawSamples(
 {
     delete d_series;
     d_series = new QwtCPointerData( xData, yData, size );
+    invalidateSpatialIndex();
+    itemChanged();
+}
+
+/*!
+  \brief Initialize the data by pointing to memory blocks of floats,
+         which are not managed by QwtPlotCurve.
+
+  Compared to doubles the samples need half of the memory and memory
+  bandwidth. They are converted, when they are painted.
+  It is important to keep the pointers during the lifetime of the 
+  underlying QwtTypedCPointerData class.
+
+  \param xData pointer to x data
+  \param yData pointer to y data
+  \param size size of x and y
+
+  \sa QwtTypedCPointerData
+*/
+void QwtPlotCurve::setRawSamples( 
+    const float *xData, const float *yData, int size )
+{
+    delete d_series;
+    d_series = new QwtTypedCPointerData<float>( xData, yData, size );
+    invalidateSpatialIndex();
     itemChanged();
 }
 
@@ -922,6 +3001,7 @@ void QwtPlotCurve::setSamples(
 {
     delete d_series;
     d_series = new QwtPointArrayData( xData, yData, size );
+    invalidateSpatialIndex();
     itemChanged();
 }
 
@@ -938,5 +3018,6 @@ void QwtPlotCurve::setSamples( const QVector<double> &xData,
 {
     delete d_series;
     d_series = new QwtPointArrayData( xData, yData );
+    invalidateSpatialIndex();
     itemChanged();
 }
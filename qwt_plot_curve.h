@@ -10,6 +10,7 @@ class QPainter;
 class QPolygonF;
 class QwtScaleMap;
 class QwtSymbol;
+class QwtColorMap;
 
 /*!
   \brief A plot item, that represents a series of points
@@ -82,6 +83,15 @@ public:
         */
         Dots,
 
+        /*!
+           Count the samples falling into each pixel of the canvas
+           and paint the counts as an image, using a color map. 
+           This is for scatter plots with so many points, that
+           drawing them as dots or symbols gives a solid blob.
+           \sa setColorMap(), QwtPlotCurve::LogDensity
+        */
+        Density,
+
         /*!
            Styles >= QwtPlotCurve::UserCurve are reserved for derived
            classes of QwtPlotCurve that overload drawCurve() with
@@ -101,6 +111,12 @@ public:
            Draws a step function from the right to the left.
          */
         Inverted = 0x01,
+
+        /*!
+           For QwtPlotCurve::Density only.
+           Map the logarithm of the counts to the colors.
+         */
+        LogDensity = 0x02
     };
 
     //! Curve attributes
@@ -151,12 +167,17 @@ public:
     bool testLegendAttribute( LegendAttribute ) const;
 
     void setRawSamples( const double *xData, const double *yData, int size );
+    void setRawSamples( const float *xData, const float *yData, int size );
     void setSamples( const double *xData, const double *yData, int size );
     void setSamples( const QVector<double> &xData, const QVector<double> &yData );
     void setSamples( const QVector<QPointF> & );
 
     int closestPoint( const QPoint &pos, double *dist = NULL ) const;
 
+    void enableSpatialIndex( bool on = true );
+    bool spatialIndexEnabled() const;
+    void invalidateSpatialIndex();
+
     double minXValue() const;
     double maxXValue() const;
     double minYValue() const;
@@ -180,10 +201,22 @@ public:
     void setSymbol( const QwtSymbol *s );
     const QwtSymbol *symbol() const;
 
+    void setColorMap( QwtColorMap * );
+    const QwtColorMap *colorMap() const;
+
+    void setRenderThreadCount( uint numThreads );
+    uint renderThreadCount() const;
+
     virtual void drawSeries( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const;
 
+    void drawSimplified( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, double tolerance ) const;
+
+    virtual void itemChanged();
+
     virtual void updateLegend( QwtLegend * ) const;
     virtual void drawLegendIdentifier( QPainter *, const QRectF & ) const;
 
@@ -201,7 +234,7 @@ public:
 
     void drawLines( QPainter *p,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-        int from, int to ) const;
+        int from, int to, double tolerance = 0.0 ) const;
 
     void drawSticks( QPainter *p,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -215,6 +248,10 @@ public:
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         int from, int to ) const;
 
+    void drawDensity( QPainter *p,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        int from, int to ) const;
+
     virtual void fillCurve( QPainter *,
         const QwtScaleMap &, const QwtScaleMap &, 
         QPolygonF & ) const;
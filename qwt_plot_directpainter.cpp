@@ -12,10 +12,15 @@
 #include "qwt_plot.h"
 #include "qwt_plot_canvas.h"
 #include "qwt_plot_seriesitem.h"
+#include "qwt_plot_curve.h"
+#include "qwt_symbol.h"
+#include "qwt_math.h"
 #include <qpainter.h>
 #include <qevent.h>
 #include <qapplication.h>
 #include <qpixmap.h>
+#include <qimage.h>
+#include <string.h>
 
 static inline void renderItem( 
     QPainter *painter, const QRect &canvasRect,
@@ -30,6 +35,78 @@ static inline void renderItem(
     seriesItem->drawSeries( painter, xMap, yMap, canvasRect, from, to );
 }
 
+/*
+  The rectangle on the canvas, that is covered by drawing the
+  points from - to. For items, where we don't know about the extent
+  of the pen, it is the complete canvas.
+ */
+static QRect qwtDirtyRect( const QRect &canvasRect,
+    const QwtPlotAbstractSeriesItem *seriesItem, int from, int to )
+{
+    const QwtPlotCurve *curve = 
+        dynamic_cast<const QwtPlotCurve *>( seriesItem );
+
+    if ( curve == NULL || curve->data() == NULL ||
+        curve->style() == QwtPlotCurve::Density ||
+        curve->style() >= QwtPlotCurve::UserCurve )
+    {
+        return canvasRect;
+    }
+
+    QRectF rect;
+    if ( curve->style() != QwtPlotCurve::Sticks &&
+        curve->brush().style() == Qt::NoBrush )
+    {
+        rect = qwtBoundingRect( *curve->data(), from, to );
+    }
+    else
+    {
+        // sticks and fillings reach the baseline
+        rect = curve->boundingRect();
+    }
+
+    if ( rect.width() < 0.0 || rect.height() < 0.0 )
+        return QRect();
+
+    const QwtPlot *plot = curve->plot();
+
+    const QRectF r = QwtScaleMap::transform( 
+        plot->canvasMap( QwtPlot::xBottom ),
+        plot->canvasMap( QwtPlot::yLeft ), rect ).normalized();
+
+    double margin = 0.5 * qMax( curve->pen().widthF(), 1.0 );
+
+    const QwtSymbol *symbol = curve->symbol();
+    if ( symbol && symbol->style() != QwtSymbol::NoSymbol )
+    {
+        const QSize sz = symbol->size();
+        margin = qMax( margin, 0.5 * qMax( sz.width(), sz.height() )
+            + qMax( symbol->pen().widthF(), 1.0 ) );
+    }
+
+    // one more pixel for antialiasing and rounding
+    const int m = qCeil( margin ) + 1;
+
+    return r.toAlignedRect().adjusted( -m, -m, m, m ) & canvasRect;
+}
+
+// shift the pixels of rect by dx pixels to the left
+static void qwtScrollImage( QImage *image, const QRect &rect, int dx )
+{
+    const QRect r = rect & image->rect();
+    if ( dx <= 0 || dx >= r.width() )
+        return;
+
+    const int bytesPerPixel = image->depth() / 8;
+
+    for ( int y = r.top(); y <= r.bottom(); y++ )
+    {
+        uchar *line = image->scanLine( y ) + r.left() * bytesPerPixel;
+        memmove( line, line + dx * bytesPerPixel, 
+            ( r.width() - dx ) * bytesPerPixel );
+    }
+}
+
 class QwtPlotDirectPainter::PrivateData
 {
 public:
@@ -65,7 +142,10 @@ QwtPlotDirectPainter::~QwtPlotDirectPainter()
   added to an existing seriesItem. drawSeries can be used to display them avoiding
   a complete redraw of the canvas.
 
-  Setting plot()->canvas()->setAttribute(Qt::WA_PaintOutsidePaintEvent, true);
+  When the canvas has a backing store ( see QwtPlotCanvas::BackingStore )
+  the points are painted into it and only the rectangle covered by
+  them is updated on screen. Otherwise setting
+  plot()->canvas()->setAttribute(Qt::WA_PaintOutsidePaintEvent, true);
   will result in faster painting, if the paint engine of the canvas widget
   supports this feature.
 
@@ -83,6 +163,35 @@ void QwtPlotDirectPainter::drawSeries(
     QwtPlotCanvas *canvas = seriesItem->plot()->canvas();
     const QRect canvasRect = canvas->contentsRect();
 
+    if ( canvas->testPaintAttribute( QwtPlotCanvas::BackingStore ) )
+    {
+        QImage *backingStore = canvas->backingStore();
+        if ( backingStore == NULL )
+        {
+            /*
+              The canvas has not been painted since the last replot
+              or resize. The pending paint event will include the
+              new points anyway.
+             */
+            return;
+        }
+
+        reset();
+
+        QPainter painter( backingStore );
+        painter.setClipRect( canvasRect );
+        renderItem( &painter, canvasRect, seriesItem, from, to );
+        painter.end();
+
+        const QRect dirtyRect = 
+            qwtDirtyRect( canvasRect, seriesItem, from, to );
+
+        if ( !dirtyRect.isEmpty() )
+            canvas->update( dirtyRect );
+
+        return;
+    }
+
     bool immediatePaint = true;
     if ( !canvas->testAttribute( Qt::WA_WState_InPaintEvent ) )
          {
@@ -123,6 +232,117 @@ void QwtPlotDirectPainter::drawSeries(
     }
 }
 
+/*!
+  \brief Scroll the canvas horizontally
+
+  Strip charts shift the scale of the x axis, whenever new samples
+  have been appended. Instead of a replot scroll() moves the content of
+  the backing store and draws the plot items only into the strip,
+  that has been exposed. When the series implements 
+  QwtSeriesData<T>::indexRange() ( f.e. QwtCircularSeriesData )
+  only the new samples are painted, so that the costs of
+  an update don't depend on the number of displayed samples.
+
+  The width of the scale interval is kept. The shift is rounded to
+  whole pixels, so that the upper bound of the scale might 
+  differ from upperBound by less than a pixel.
+
+  A replot is done instead, when the canvas has no backing store, 
+  the scale is not linear or the shift is larger than the canvas.
+
+  \param plot Plot
+  \param axisId xBottom or xTop
+  \param upperBound New upper bound of the scale. It should be the
+                    x coordinate of the latest sample, so that the lines
+                    to the new samples start inside of the exposed strip.
+
+  \note The scales of all other axes have to be fixed.
+  \sa QwtCircularSeriesData
+*/
+void QwtPlotDirectPainter::scroll( 
+    QwtPlot *plot, int axisId, double upperBound )
+{
+    if ( plot == NULL || 
+        !( axisId == QwtPlot::xBottom || axisId == QwtPlot::xTop ) )
+    {
+        return;
+    }
+
+    reset();
+
+    QwtPlotCanvas *canvas = plot->canvas();
+    const QRect canvasRect = canvas->contentsRect();
+
+    const QwtScaleMap map = plot->canvasMap( axisId );
+    const double width = map.s2() - map.s1();
+    const double pixelWidth = map.p2() - map.p1();
+
+    QImage *backingStore = NULL;
+    if ( canvas->testPaintAttribute( QwtPlotCanvas::BackingStore ) )
+        backingStore = canvas->backingStore();
+
+    const int dx = ( width > 0.0 && pixelWidth > 0.0 ) 
+        ? qRound( ( upperBound - map.s2() ) * pixelWidth / width ) : -1;
+
+    if ( backingStore == NULL || dx < 0 || dx >= canvasRect.width() ||
+        map.transformation()->type() != QwtScaleTransformation::Linear ||
+        canvas->testAttribute( Qt::WA_StyledBackground ) )
+    {
+        plot->setAxisScale( axisId, upperBound - width, upperBound );
+        plot->replot();
+        return;
+    }
+
+    // moving by whole pixels keeps the content in sync with the scale
+
+    const double shift = dx * width / pixelWidth;
+    plot->setAxisScale( axisId, map.s1() + shift, map.s2() + shift );
+    plot->updateAxes();
+
+    double pixelRatio = 1.0;
+#if QT_VERSION >= 0x050100
+    pixelRatio = backingStore->devicePixelRatio();
+#endif
+
+    const QRect deviceRect( qRound( canvasRect.x() * pixelRatio ),
+        qRound( canvasRect.y() * pixelRatio ),
+        qRound( canvasRect.width() * pixelRatio ),
+        qRound( canvasRect.height() * pixelRatio ) );
+
+    qwtScrollImage( backingStore, deviceRect, qRound( dx * pixelRatio ) );
+
+    /*
+      The lines to the new samples start at the previous
+      upper bound, but the pen might reach a bit further left.
+     */
+    const int margin = 2;
+
+    const QRect strip = QRect( canvasRect.right() + 1 - dx - margin, 
+        canvasRect.top(), dx + margin, canvasRect.height() ) & canvasRect;
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+        maps[axis] = plot->canvasMap( axis );
+
+    // limiting the map to the strip restricts the painted samples
+
+    QwtScaleMap &stripMap = maps[axisId];
+    const double x1 = strip.left();
+    const double x2 = strip.right() + 1;
+    stripMap.setScaleInterval( 
+        stripMap.invTransform( x1 ), stripMap.invTransform( x2 ) );
+    stripMap.setPaintInterval( x1, x2 );
+
+    QPainter painter( backingStore );
+    painter.setClipRect( strip );
+    painter.fillRect( strip, canvas->palette().brush( canvas->backgroundRole() ) );
+
+    plot->drawItems( &painter, canvasRect, maps );
+    painter.end();
+
+    canvas->update( canvasRect );
+}
+
 //! Close the internal QPainter
 void QwtPlotDirectPainter::reset()
 {
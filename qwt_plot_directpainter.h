@@ -3,6 +3,7 @@
 #include <qobject.h>
 
 class QRegion;
+class QwtPlot;
 class QwtPlotAbstractSeriesItem;
 
 /*!
@@ -16,6 +17,9 @@ class QwtPlotAbstractSeriesItem;
     subsets ( f.e all additions points ) without erasing/repainting
     the plot canvas.
 
+    For strip charts scroll() shifts the content of the canvas and
+    repaints only the strip, that has been exposed.
+
     \warning Incremental painting will only help when no replot is triggered
              by another operation ( like changing scales ) and nothing needs
              to be erased.
@@ -27,6 +31,7 @@ public:
     virtual ~QwtPlotDirectPainter();
 
     void drawSeries( QwtPlotAbstractSeriesItem *, int from, int to );
+    void scroll( QwtPlot *, int axisId, double upperBound );
     void reset();
 
     virtual bool eventFilter( QObject *, QEvent * );
@@ -170,8 +170,32 @@ void QwtPlotGrid::draw( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QRectF &canvasRect ) const
 {
-    QwtScaleDiv *xScaleDiv = plot()->axisScaleDiv(QwtPlot::xBottom);
-    QwtScaleDiv *yScaleDiv = plot()->axisScaleDiv(QwtPlot::yLeft);
+    if ( plot() == NULL )
+        return;
+
+    draw( painter, xMap, yMap, canvasRect,
+        *plot()->axisScaleDiv( QwtPlot::xBottom ),
+        *plot()->axisScaleDiv( QwtPlot::yLeft ) );
+}
+
+/*!
+  \brief Draw the grid for explicit scale divisions
+
+  The scale divisions of the plot are not used, what is needed
+  when the grid is painted without a plot widget like in QwtPlotScene.
+
+  \param painter  Painter
+  \param xMap X axis map
+  \param yMap Y axis
+  \param canvasRect Contents rect of the plot canvas
+  \param xScaleDiv Scale division for the vertical lines
+  \param yScaleDiv Scale division for the horizontal lines
+*/
+void QwtPlotGrid::draw( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, const QwtScaleDiv &xScaleDiv,
+    const QwtScaleDiv &yScaleDiv ) const
+{
 
     //  draw minor gridlines
     QPen minPen = d_data->minPen;
@@ -182,17 +206,17 @@ void QwtPlotGrid::draw( QPainter *painter,
     if ( d_data->xEnabled && d_data->xMinEnabled )
     {
         drawLines( painter, canvasRect, Qt::Vertical, xMap,
-            xScaleDiv->ticks( QwtScaleDiv::MinorTick ) );
+            xScaleDiv.ticks( QwtScaleDiv::MinorTick ) );
         drawLines( painter, canvasRect, Qt::Vertical, xMap,
-            xScaleDiv->ticks( QwtScaleDiv::MediumTick ) );
+            xScaleDiv.ticks( QwtScaleDiv::MediumTick ) );
     }
 
     if ( d_data->yEnabled && d_data->yMinEnabled )
     {
         drawLines( painter, canvasRect, Qt::Horizontal, yMap,
-            yScaleDiv->ticks( QwtScaleDiv::MinorTick ) );
+            yScaleDiv.ticks( QwtScaleDiv::MinorTick ) );
         drawLines( painter, canvasRect, Qt::Horizontal, yMap,
-            yScaleDiv->ticks( QwtScaleDiv::MediumTick ) );
+            yScaleDiv.ticks( QwtScaleDiv::MediumTick ) );
     }
 
     //  draw major gridlines
@@ -204,13 +228,13 @@ void QwtPlotGrid::draw( QPainter *painter,
     if ( d_data->xEnabled )
     {
         drawLines( painter, canvasRect, Qt::Vertical, xMap,
-            xScaleDiv->ticks( QwtScaleDiv::MajorTick ) );
+            xScaleDiv.ticks( QwtScaleDiv::MajorTick ) );
     }
 
     if ( d_data->yEnabled )
     {
         drawLines( painter, canvasRect, Qt::Horizontal, yMap,
-            yScaleDiv->ticks( QwtScaleDiv::MajorTick ) );
+            yScaleDiv.ticks( QwtScaleDiv::MajorTick ) );
     }
 }
 
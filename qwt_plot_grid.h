@@ -50,6 +50,11 @@ public:
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &rect ) const;
 
+    void draw( QPainter *p,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &rect, const QwtScaleDiv &xScaleDiv,
+        const QwtScaleDiv &yScaleDiv ) const;
+
 private:
     void drawLines( QPainter *painter, const QRectF &,
         Qt::Orientation orientation, const QwtScaleMap &,
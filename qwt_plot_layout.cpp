@@ -19,7 +19,8 @@
 class QwtPlotLayout::LayoutData
 {
 public:
-    void init( const QwtPlot *, const QRectF &rect );
+    void init( const QwtPlot *, QwtPlot::LegendPosition,
+        const QRectF &rect );
 
     struct t_legendData
     {
@@ -54,11 +55,12 @@ public:
   Extract all layout relevant data from the plot components
 */
 
-void QwtPlotLayout::LayoutData::init( const QwtPlot *plot, const QRectF &rect )
+void QwtPlotLayout::LayoutData::init( const QwtPlot *plot,
+    QwtPlot::LegendPosition legendPos, const QRectF &rect )
 {
     // legend
 
-    if ( plot->plotLayout()->legendPosition() != QwtPlot::ExternalLegend
+    if ( legendPos != QwtPlot::ExternalLegend
         && plot->legend() )
     {
         legend.vScrollBarWidth =
@@ -682,7 +684,7 @@ void QwtPlotLayout::activate( const QwtPlot *plot,
     // We extract all layout relevant data from the widgets,
     // filter them through pfilter and save them to d_data->layoutData.
 
-    d_data->layoutData.init( plot, rect );
+    d_data->layoutData.init( plot, d_data->legendPos, rect );
 
     if ( d_data->legendPos != QwtPlot::ExternalLegend
         && plot->legend() && !plot->legend()->isEmpty() )
@@ -11,6 +11,7 @@
 #include "qwt_plot.h"
 #include "qwt_plot_canvas.h"
 #include "qwt_plot_layout.h"
+#include "qwt_plot_curve.h"
 #include "qwt_legend.h"
 #include "qwt_legend_item.h"
 #include "qwt_dyngrid_layout.h"
@@ -44,6 +45,47 @@ static void qwtRenderBackground( QPainter *painter,
     }
 }
 
+//! Constructor
+QwtPlotRenderer::QwtPlotRenderer():
+    d_simplificationTolerance( 0.0 )
+{
+}
+
+//! Destructor
+QwtPlotRenderer::~QwtPlotRenderer()
+{
+}
+
+/*!
+  \brief Set the tolerance for simplifying curve lines
+
+  When exporting to vector formats like PDF or SVG each painted point
+  ends up in the document. With a tolerance > 0.0 curves in
+  QwtPlotCurve::Lines style are simplified, so that they deviate by
+  not more than the tolerance from the exact polyline. As the tolerance
+  is in coordinates of the paint device, the size of the document
+  depends on the resolution of the target, instead of the number of samples.
+
+  A tolerance of 0.5 - 1.0 device pixels is usually not visible.
+  The default setting is 0.0, what disables the simplification.
+
+  \param tolerance Tolerance in paint device coordinates
+  \sa simplificationTolerance(), QwtPlotCurve::drawSimplified()
+*/
+void QwtPlotRenderer::setSimplificationTolerance( double tolerance )
+{
+    d_simplificationTolerance = qMax( tolerance, 0.0 );
+}
+
+/*!
+  \return Tolerance for simplifying curve lines
+  \sa setSimplificationTolerance()
+*/
+double QwtPlotRenderer::simplificationTolerance() const
+{
+    return d_simplificationTolerance;
+}
+
 /*!
   Paint the contents of a QwtPlot instance into a given rectangle.
 
@@ -53,7 +95,7 @@ static void qwtRenderBackground( QPainter *painter,
 
   \sa renderDocument(), renderTo(), QwtPainter::setRoundingAlignment()
 */
-void QwtPlotRenderer::render( QwtPlot *plot,
+void QwtPlotRenderer::render( const QwtPlot *plot,
     QPainter *painter, const QRectF &plotRect ) const
 {
     int axisId;
@@ -76,42 +118,49 @@ void QwtPlotRenderer::render( QwtPlot *plot,
 
     painter->save();
 
-    // Calculate the layout for the print.
+    /*
+      Calculate the layout for the print with a layout of our own,
+      leaving the one of the plot widget untouched.
+     */
+
+    const QwtPlotLayout *plotLayout = plot->plotLayout();
+
+    QwtPlotLayout layout;
+    layout.setSpacing( plotLayout->spacing() );
+    layout.setLegendPosition( plotLayout->legendPosition(),
+        plotLayout->legendRatio() );
 
     const QRectF layoutRect = transform.inverted().mapRect( plotRect );
-    plot->plotLayout()->activate( plot, layoutRect );
+    layout.activate( plot, layoutRect );
 
     painter->setWorldTransform( transform, true );
 
     // canvas
 
     QwtScaleMap maps[QwtPlot::axisCnt];
-    buildCanvasMaps( plot, plot->plotLayout()->canvasRect(), maps );
-    renderCanvas( plot, painter, plot->plotLayout()->canvasRect(), maps );
+    buildCanvasMaps( plot, &layout, layout.canvasRect(), maps );
+    renderCanvas( plot, painter, layout.canvasRect(), maps );
 
     if ( !plot->titleLabel()->text().isEmpty() )
     {
-        renderTitle( plot, painter, plot->plotLayout()->titleRect() );
+        renderTitle( plot, painter, layout.titleRect() );
     }
 
     if ( plot->legend() && !plot->legend()->isEmpty() )
     {
-        renderLegend( plot, painter, plot->plotLayout()->legendRect() );
+        renderLegend( plot, painter, layout.legendRect() );
     }
 
     for ( axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
     {
-        QwtScaleWidget *scaleWidget = plot->axisWidget( axisId );
+        const QwtScaleWidget *scaleWidget = plot->axisWidget( axisId );
         if ( scaleWidget )
         {
             renderScale( plot, painter, axisId,
-                scaleWidget->margin(), plot->plotLayout()->scaleRect( axisId ) );
+                scaleWidget->margin(), layout.scaleRect( axisId ) );
         }
     }
 
-
-    plot->plotLayout()->invalidate();
-
     painter->restore();
 }
 
@@ -304,10 +353,18 @@ void QwtPlotRenderer::renderScale( const QwtPlot *plot,
 
     painter->setFont( scaleWidget->font() );
 
+    /*
+      The scale draw of the widget - including an overloaded label() -
+      is temporarily moved to the geometry of the document. As render()
+      runs in the GUI thread only, this doesn't need to be serialized.
+     */
     QwtScaleDraw *sd = const_cast<QwtScaleDraw *>( scaleWidget->scaleDraw() );
+
     const QPointF sdPos = sd->pos;
     const double sdLength = sd->len;
+    const QwtScaleDraw::Alignment sdAlignment = sd->alignment;
 
+    sd->setAlignment( align );
     sd->move( x, y );
     sd->setLength( w );
 
@@ -316,6 +373,7 @@ void QwtPlotRenderer::renderScale( const QwtPlot *plot,
     sd->draw( painter, palette );
 
     // reset previous values
+    sd->setAlignment( sdAlignment );
     sd->move( sdPos );
     sd->setLength( sdLength );
 
@@ -345,13 +403,51 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
     int fw = plot->canvas()->frameWidth();
     painter->setClipRect( canvasRect.adjusted(fw, fw, -fw, -fw) );
 
-    plot->drawItems( painter, canvasRect, map );
+    const double tolerance = d_simplificationTolerance;
+    if ( tolerance <= 0.0 )
+    {
+        plot->drawItems( painter, canvasRect, map );
+    }
+    else
+    {
+        const QwtPlotItemList& itmList = plot->itemList();
+        for ( QwtPlotItemIterator it = itmList.begin();
+            it != itmList.end(); ++it )
+        {
+            const QwtPlotItem *item = *it;
+            if ( item == NULL || !item->isVisible() )
+                continue;
+
+            painter->save();
+
+            painter->setRenderHint( QPainter::Antialiasing,
+                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+            const QwtPlotCurve *curve =
+                dynamic_cast<const QwtPlotCurve *>( item );
+            if ( curve )
+            {
+                curve->drawSimplified( painter,
+                    map[QwtPlot::xBottom], map[QwtPlot::yLeft],
+                    canvasRect, tolerance );
+            }
+            else
+            {
+                item->draw( painter,
+                    map[QwtPlot::xBottom], map[QwtPlot::yLeft],
+                    canvasRect );
+            }
+
+            painter->restore();
+        }
+    }
 
     painter->restore();
 }
 
 /*!
-   Calculated the scale maps for rendering the canvas
+   Calculated the scale maps for rendering the canvas from the
+   layout of the plot widget
 
    \param plot Plot widget
    \param canvasRect Target rectangle
@@ -359,6 +455,21 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
 */
 void QwtPlotRenderer::buildCanvasMaps( const QwtPlot *plot,
     const QRectF &canvasRect, QwtScaleMap maps[] ) const
+{
+    buildCanvasMaps( plot, plot->plotLayout(), canvasRect, maps );
+}
+
+/*!
+   Calculated the scale maps for rendering the canvas
+
+   \param plot Plot widget
+   \param layout Layout, that has been activated for the target rectangle
+   \param canvasRect Target rectangle
+   \param maps Scale maps to be calculated
+*/
+void QwtPlotRenderer::buildCanvasMaps( const QwtPlot *plot,
+    const QwtPlotLayout *layout, const QRectF &canvasRect,
+    QwtScaleMap maps[] ) const
 {
     for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
     {
@@ -372,7 +483,7 @@ void QwtPlotRenderer::buildCanvasMaps( const QwtPlot *plot,
         double from, to;
         if ( plot->axisEnabled( axisId ) )
         {
-            const QRectF &scaleRect = plot->plotLayout()->scaleRect( axisId );
+            const QRectF &scaleRect = layout->scaleRect( axisId );
 
             if ( axisId == QwtPlot::xTop || axisId == QwtPlot::xBottom )
             {
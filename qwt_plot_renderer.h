@@ -2,6 +2,7 @@
 
 class QWidget;
 class QwtPlot;
+class QwtPlotLayout;
 class QwtScaleMap;
 class QRectF;
 class QPainter;
@@ -9,11 +10,28 @@ class QPainter;
 /*!
     \brief Renderer for exporting a plot to a document, a printer
            or anything else, that is supported by QPainter/QPaintDevice
+
+    The renderer calculates the layout with a QwtPlotLayout and scale maps
+    of its own. The scales are drawn by the scale draws of the axis widgets,
+    so that custom labels are exported as they are displayed. Their
+    geometry is restored after rendering.
+
+    \warning The layout is calculated from the extents of the scale widgets,
+             what fills the label caches of their scale draws, and the
+             scale draws are moved temporarily. So render() has to be
+             called from the GUI thread. For rendering in a worker thread
+             use QwtPlotScene.
 */
 class QwtPlotRenderer
 {
 public:
-    virtual void render( QwtPlot *,
+    QwtPlotRenderer();
+    virtual ~QwtPlotRenderer();
+
+    void setSimplificationTolerance( double );
+    double simplificationTolerance() const;
+
+    virtual void render( const QwtPlot *,
         QPainter *, const QRectF &rect ) const;
 
     virtual void renderLegendItem( const QwtPlot *, 
@@ -35,4 +53,10 @@ public:
 protected:
     void buildCanvasMaps( const QwtPlot *,
         const QRectF &, QwtScaleMap maps[] ) const;
+
+    void buildCanvasMaps( const QwtPlot *, const QwtPlotLayout *,
+        const QRectF &, QwtScaleMap maps[] ) const;
+
+private:
+    double d_simplificationTolerance;
 };
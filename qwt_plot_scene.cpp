@@ -0,0 +1,882 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_scene.h"
+#include "qwt_plot_item.h"
+#include "qwt_plot_grid.h"
+#include "qwt_plot_canvas.h"
+#include "qwt_plot_layout.h"
+#include "qwt_scale_widget.h"
+#include "qwt_scale_engine.h"
+#include "qwt_scale_draw.h"
+#include "qwt_scale_map.h"
+#include "qwt_text_label.h"
+#include "qwt_painter.h"
+#include "qwt_math.h"
+#include <qpainter.h>
+#include <qpalette.h>
+#include <qtransform.h>
+
+class QwtPlotScene::AxisData
+{
+public:
+    AxisData():
+        isEnabled( false ),
+        transformation( NULL ),
+        margin( 4 ),
+        spacing( 2 )
+    {
+        font.setPointSize( 10 );
+
+        const QwtScaleDraw scaleDraw;
+        for ( int i = 0; i < QwtScaleDiv::NTickTypes; i++ )
+        {
+            tickLength[i] = scaleDraw.tickLength(
+                static_cast<QwtScaleDiv::TickType>( i ) );
+        }
+
+        scaleSpacing = scaleDraw.spacing();
+        penWidth = scaleDraw.penWidth();
+        multiplier = scaleDraw.Multiplier;
+
+        scaleDiv = QwtLinearScaleEngine().divideScale( 0.0, 1000.0, 8, 5 );
+    }
+
+    ~AxisData()
+    {
+        delete transformation;
+    }
+
+    bool isEnabled;
+
+    QwtScaleDiv scaleDiv;
+    QwtScaleTransformation *transformation;
+
+    QwtText title;
+    QFont font;
+    QPalette palette;
+
+    int margin;
+    int spacing;
+
+    double tickLength[QwtScaleDiv::NTickTypes];
+    double scaleSpacing;
+    int penWidth;
+    double multiplier;
+};
+
+class QwtPlotScene::LayoutData
+{
+public:
+    QRectF titleRect;
+    QRectF scaleRect[QwtPlot::axisCnt];
+    QRectF canvasRect;
+};
+
+class QwtPlotScene::PrivateData
+{
+public:
+    PrivateData():
+        color( Qt::black ),
+        background( Qt::white ),
+        canvasBackground( Qt::white ),
+        margin( 0 ),
+        spacing( 5 )
+    {
+        titleFont.setPointSize( 12 );
+        titleFont.setBold( true );
+    }
+
+    class LessZThan
+    {
+    public:
+        inline bool operator()( const QwtPlotItem *item1,
+            const QwtPlotItem *item2 ) const
+        {
+            return item1->z() < item2->z();
+        }
+    };
+
+    QwtText title;
+    QFont titleFont;
+    QColor color;
+
+    QBrush background;
+    QBrush canvasBackground;
+
+    int margin;
+    int spacing;
+
+    AxisData axisData[QwtPlot::axisCnt];
+
+    QList<const QwtPlotItem *> items;
+};
+
+static QwtScaleDraw::Alignment qwtScaleAlignment( int axisId )
+{
+    switch ( axisId )
+    {
+        case QwtPlot::yLeft:
+            return QwtScaleDraw::LeftScale;
+        case QwtPlot::yRight:
+            return QwtScaleDraw::RightScale;
+        case QwtPlot::xTop:
+            return QwtScaleDraw::TopScale;
+        case QwtPlot::xBottom:
+        default:
+            return QwtScaleDraw::BottomScale;
+    }
+}
+
+static inline bool qwtIsHorizontal( int axisId )
+{
+    return axisId == QwtPlot::xTop || axisId == QwtPlot::xBottom;
+}
+
+/*!
+  Create an empty scene
+
+  Only the QwtPlot::yLeft and QwtPlot::xBottom axes are enabled,
+  both showing the interval [0.0, 1000.0].
+*/
+QwtPlotScene::QwtPlotScene()
+{
+    d_data = new PrivateData;
+
+    d_data->axisData[QwtPlot::yLeft].isEnabled = true;
+    d_data->axisData[QwtPlot::xBottom].isEnabled = true;
+}
+
+/*!
+  Create a scene from the current state of a plot
+
+  Title, axes, colors, fonts, the layout spacing and the attached
+  items are taken from the plot. The constructor needs to be called
+  in the GUI thread, rendering the scene later can be done in any thread.
+
+  \param plot Plot widget
+*/
+QwtPlotScene::QwtPlotScene( const QwtPlot *plot )
+{
+    d_data = new PrivateData;
+
+    if ( plot == NULL )
+        return;
+
+    d_data->title = plot->title();
+    d_data->titleFont = plot->titleLabel()->font();
+    d_data->color = plot->titleLabel()->palette().color(
+        QPalette::Active, QPalette::Text );
+
+    d_data->background = plot->palette().brush( plot->backgroundRole() );
+
+    const QwtPlotCanvas *canvas = plot->canvas();
+    d_data->canvasBackground =
+        canvas->palette().brush( canvas->backgroundRole() );
+
+    d_data->spacing = plot->plotLayout()->spacing();
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        AxisData &axisData = d_data->axisData[axisId];
+
+        axisData.isEnabled = plot->axisEnabled( axisId );
+        axisData.scaleDiv = *plot->axisScaleDiv( axisId );
+        axisData.transformation =
+            plot->axisScaleEngine( axisId )->transformation();
+
+        const QwtScaleWidget *scaleWidget = plot->axisWidget( axisId );
+        if ( scaleWidget )
+        {
+            axisData.title = scaleWidget->title();
+            axisData.font = scaleWidget->font();
+            axisData.palette = scaleWidget->palette();
+            axisData.palette.setCurrentColorGroup( QPalette::Active );
+            axisData.margin = scaleWidget->margin();
+            axisData.spacing = scaleWidget->spacing();
+
+            const QwtScaleDraw *scaleDraw = scaleWidget->scaleDraw();
+            for ( int i = 0; i < QwtScaleDiv::NTickTypes; i++ )
+            {
+                axisData.tickLength[i] = scaleDraw->tickLength(
+                    static_cast<QwtScaleDiv::TickType>( i ) );
+            }
+
+            axisData.scaleSpacing = scaleDraw->spacing();
+            axisData.penWidth = scaleDraw->penWidth();
+            axisData.multiplier = scaleDraw->Multiplier;
+        }
+    }
+
+    const QwtPlotItemList &itemList = plot->itemList();
+    for ( QwtPlotItemIterator it = itemList.begin();
+        it != itemList.end(); ++it )
+    {
+        attachItem( *it );
+    }
+}
+
+//! Destructor
+QwtPlotScene::~QwtPlotScene()
+{
+    delete d_data;
+}
+
+/*!
+  Set the title of the plot
+  \param title Title
+  \sa title()
+*/
+void QwtPlotScene::setTitle( const QwtText &title )
+{
+    d_data->title = title;
+}
+
+//! \return Title of the plot
+QwtText QwtPlotScene::title() const
+{
+    return d_data->title;
+}
+
+/*!
+  Set the font of the title
+  \param font Font
+  \sa titleFont()
+*/
+void QwtPlotScene::setTitleFont( const QFont &font )
+{
+    d_data->titleFont = font;
+}
+
+//! \return Font of the title
+QFont QwtPlotScene::titleFont() const
+{
+    return d_data->titleFont;
+}
+
+/*!
+  Set the color of the title
+  \param color Color
+  \sa color()
+*/
+void QwtPlotScene::setColor( const QColor &color )
+{
+    d_data->color = color;
+}
+
+//! \return Color of the title
+QColor QwtPlotScene::color() const
+{
+    return d_data->color;
+}
+
+/*!
+  Set the brush for the background outside of the canvas
+  \param brush Brush
+  \sa background(), setCanvasBackground()
+*/
+void QwtPlotScene::setBackground( const QBrush &brush )
+{
+    d_data->background = brush;
+}
+
+//! \return Brush for the background outside of the canvas
+QBrush QwtPlotScene::background() const
+{
+    return d_data->background;
+}
+
+/*!
+  Set the background of the canvas
+  \param brush Brush
+  \sa canvasBackground(), setBackground()
+*/
+void QwtPlotScene::setCanvasBackground( const QBrush &brush )
+{
+    d_data->canvasBackground = brush;
+}
+
+//! \return Background of the canvas
+QBrush QwtPlotScene::canvasBackground() const
+{
+    return d_data->canvasBackground;
+}
+
+/*!
+  Set the margin around the plot
+  \param margin Margin in screen pixels
+  \sa margin()
+*/
+void QwtPlotScene::setMargin( int margin )
+{
+    d_data->margin = qMax( margin, 0 );
+}
+
+//! \return Margin around the plot
+int QwtPlotScene::margin() const
+{
+    return d_data->margin;
+}
+
+/*!
+  Set the distance between the title and the other components
+  \param spacing Spacing in screen pixels
+  \sa spacing()
+*/
+void QwtPlotScene::setSpacing( int spacing )
+{
+    d_data->spacing = qMax( spacing, 0 );
+}
+
+//! \return Distance between the title and the other components
+int QwtPlotScene::spacing() const
+{
+    return d_data->spacing;
+}
+
+/*!
+  Enable or disable an axis
+  \param axisId Axis index
+  \param on On/Off
+  \sa axisEnabled()
+*/
+void QwtPlotScene::enableAxis( int axisId, bool on )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].isEnabled = on;
+}
+
+//! \return true if the axis is enabled
+bool QwtPlotScene::axisEnabled( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].isEnabled;
+
+    return false;
+}
+
+/*!
+  Assign the scale division of an axis
+
+  The scale division is also used for the maps of the canvas,
+  even when the axis is disabled.
+
+  \param axisId Axis index
+  \param scaleDiv Scale division
+  \sa axisScaleDiv()
+*/
+void QwtPlotScene::setAxisScaleDiv( int axisId, const QwtScaleDiv &scaleDiv )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].scaleDiv = scaleDiv;
+}
+
+//! \return Scale division of an axis
+const QwtScaleDiv &QwtPlotScene::axisScaleDiv( int axisId ) const
+{
+    if ( axisId < 0 || axisId >= QwtPlot::axisCnt )
+        axisId = QwtPlot::xBottom;
+
+    return d_data->axisData[axisId].scaleDiv;
+}
+
+/*!
+  Assign the transformation of an axis
+
+  \param axisId Axis index
+  \param transformation Transformation, NULL means linear.
+                        The scene takes ownership.
+  \sa axisTransformation()
+*/
+void QwtPlotScene::setAxisTransformation( int axisId,
+    QwtScaleTransformation *transformation )
+{
+    if ( axisId < 0 || axisId >= QwtPlot::axisCnt )
+    {
+        delete transformation;
+        return;
+    }
+
+    AxisData &axisData = d_data->axisData[axisId];
+    if ( transformation != axisData.transformation )
+    {
+        delete axisData.transformation;
+        axisData.transformation = transformation;
+    }
+}
+
+//! \return Transformation of an axis, NULL for linear
+const QwtScaleTransformation *QwtPlotScene::axisTransformation(
+    int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].transformation;
+
+    return NULL;
+}
+
+/*!
+  Set the title of an axis
+  \param axisId Axis index
+  \param title Title
+  \sa axisTitle()
+*/
+void QwtPlotScene::setAxisTitle( int axisId, const QwtText &title )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].title = title;
+}
+
+//! \return Title of an axis
+QwtText QwtPlotScene::axisTitle( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].title;
+
+    return QwtText();
+}
+
+/*!
+  Set the font of the tick labels and the title of an axis
+  \param axisId Axis index
+  \param font Font
+  \sa axisFont()
+*/
+void QwtPlotScene::setAxisFont( int axisId, const QFont &font )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].font = font;
+}
+
+//! \return Font of an axis
+QFont QwtPlotScene::axisFont( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].font;
+
+    return QFont();
+}
+
+/*!
+  Set the palette of an axis
+
+  QPalette::Text is used for labels and title, QPalette::WindowText
+  for ticks and backbone.
+
+  \param axisId Axis index
+  \param palette Palette
+  \sa axisPalette()
+*/
+void QwtPlotScene::setAxisPalette( int axisId, const QPalette &palette )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        d_data->axisData[axisId].palette = palette;
+}
+
+//! \return Palette of an axis
+QPalette QwtPlotScene::axisPalette( int axisId ) const
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+        return d_data->axisData[axisId].palette;
+
+    return QPalette();
+}
+
+/*!
+  Insert an item into the scene
+
+  The items are painted in the order of their z value.
+  The scene doesn't take ownership and never modifies the item.
+
+  \param item Plot item
+  \sa detachItem(), detachItems()
+*/
+void QwtPlotScene::attachItem( const QwtPlotItem *item )
+{
+    if ( item == NULL )
+        return;
+
+    QList<const QwtPlotItem *> &items = d_data->items;
+
+    QList<const QwtPlotItem *>::iterator it = qUpperBound(
+        items.begin(), items.end(), item, PrivateData::LessZThan() );
+    items.insert( it, item );
+}
+
+/*!
+  Remove an item from the scene
+  \param item Plot item
+  \sa attachItem(), detachItems()
+*/
+void QwtPlotScene::detachItem( const QwtPlotItem *item )
+{
+    d_data->items.removeAll( item );
+}
+
+//! Remove all items from the scene
+void QwtPlotScene::detachItems()
+{
+    d_data->items.clear();
+}
+
+//! \return Items of the scene, sorted by their z value
+QList<const QwtPlotItem *> QwtPlotScene::items() const
+{
+    return d_data->items;
+}
+
+/*!
+  Calculate the map of an axis for a canvas rectangle
+
+  \param axisId Axis index
+  \param canvasRect Canvas rectangle
+  \return Map translating between scale and paint device coordinates
+*/
+QwtScaleMap QwtPlotScene::canvasMap( int axisId,
+    const QRectF &canvasRect ) const
+{
+    QwtScaleMap map;
+    if ( axisId < 0 || axisId >= QwtPlot::axisCnt )
+        return map;
+
+    const AxisData &axisData = d_data->axisData[axisId];
+
+    if ( axisData.transformation )
+        map.setTransformation( axisData.transformation->copy() );
+
+    map.setScaleInterval( axisData.scaleDiv.lowerBound(),
+        axisData.scaleDiv.upperBound() );
+
+    if ( qwtIsHorizontal( axisId ) )
+        map.setPaintInterval( canvasRect.left(), canvasRect.right() );
+    else
+        map.setPaintInterval( canvasRect.bottom(), canvasRect.top() );
+
+    return map;
+}
+
+/*!
+  Paint the scene into a given rectangle
+
+  The layout is calculated in screen metrics and painted with
+  a scaled painter, like it is done by QwtPlotRenderer. No widget is
+  involved, so render() can be called in any thread.
+
+  \param painter Painter
+  \param rect Bounding rectangle
+  \sa toImage()
+*/
+void QwtPlotScene::render( QPainter *painter, const QRectF &rect ) const
+{
+    if ( painter == NULL || !painter->isActive() || !rect.isValid() )
+        return;
+
+    const QPaintDevice *screen = QwtPainter::screenDevice();
+
+    QTransform transform;
+    transform.scale(
+        double( painter->device()->logicalDpiX() ) / screen->logicalDpiX(),
+        double( painter->device()->logicalDpiY() ) / screen->logicalDpiY() );
+
+    const QRectF layoutRect = transform.inverted().mapRect( rect );
+
+    LayoutData layoutData;
+    layout( layoutRect, layoutData );
+
+    painter->save();
+    painter->setWorldTransform( transform, true );
+
+    painter->fillRect( layoutRect, d_data->background );
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        maps[axisId] = canvasMap( axisId, layoutData.canvasRect );
+
+    renderCanvas( painter, layoutData.canvasRect, maps );
+
+    if ( !d_data->title.isEmpty() )
+    {
+        painter->save();
+        painter->setFont( d_data->titleFont );
+        painter->setPen( d_data->color );
+        d_data->title.draw( painter, layoutData.titleRect );
+        painter->restore();
+    }
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        const AxisData &axisData = d_data->axisData[axisId];
+        if ( !axisData.isEnabled )
+            continue;
+
+        const QRectF &scaleRect = layoutData.scaleRect[axisId];
+        const QwtScaleDraw::Alignment align = qwtScaleAlignment( axisId );
+
+        // a scale draw of our own, the label cache is not thread-safe
+
+        QwtScaleDraw scaleDraw;
+        scaleDraw.setAlignment( align );
+        scaleDraw.setScaleDiv( axisData.scaleDiv );
+        if ( axisData.transformation )
+            scaleDraw.setTransformation( axisData.transformation->copy() );
+
+        for ( int i = 0; i < QwtScaleDiv::NTickTypes; i++ )
+        {
+            scaleDraw.setTickLength( static_cast<QwtScaleDiv::TickType>( i ),
+                axisData.tickLength[i] );
+        }
+        scaleDraw.setSpacing( axisData.scaleSpacing );
+        scaleDraw.setPenWidth( axisData.penWidth );
+        scaleDraw.Multiplier = axisData.multiplier;
+
+        switch ( align )
+        {
+            case QwtScaleDraw::LeftScale:
+                scaleDraw.move( scaleRect.right() - axisData.margin,
+                    scaleRect.top() );
+                break;
+            case QwtScaleDraw::RightScale:
+                scaleDraw.move( scaleRect.left() + axisData.margin,
+                    scaleRect.top() );
+                break;
+            case QwtScaleDraw::TopScale:
+                scaleDraw.move( scaleRect.left(),
+                    scaleRect.bottom() - axisData.margin );
+                break;
+            case QwtScaleDraw::BottomScale:
+            default:
+                scaleDraw.move( scaleRect.left(),
+                    scaleRect.top() + axisData.margin );
+                break;
+        }
+
+        if ( scaleDraw.orientation() == Qt::Horizontal )
+            scaleDraw.setLength( scaleRect.width() );
+        else
+            scaleDraw.setLength( scaleRect.height() );
+
+        painter->save();
+
+        painter->setFont( axisData.font );
+        scaleDraw.draw( painter, axisData.palette );
+
+        if ( !axisData.title.isEmpty() )
+        {
+            const double titleOffset = axisData.margin + axisData.spacing
+                + qCeil( scaleDraw.extent( axisData.font ) );
+
+            QRectF r = scaleRect;
+            double angle = 0.0;
+            int flags = axisData.title.renderFlags() &
+                ~( Qt::AlignTop | Qt::AlignBottom | Qt::AlignVCenter );
+
+            switch ( align )
+            {
+                case QwtScaleDraw::LeftScale:
+                    angle = -90.0;
+                    flags |= Qt::AlignTop;
+                    r.setRect( r.left(), r.bottom(),
+                        r.height(), r.width() - titleOffset );
+                    break;
+                case QwtScaleDraw::RightScale:
+                    angle = -90.0;
+                    flags |= Qt::AlignTop;
+                    r.setRect( r.left() + titleOffset, r.bottom(),
+                        r.height(), r.width() - titleOffset );
+                    break;
+                case QwtScaleDraw::BottomScale:
+                    flags |= Qt::AlignBottom;
+                    r.setTop( r.top() + titleOffset );
+                    break;
+                case QwtScaleDraw::TopScale:
+                default:
+                    flags |= Qt::AlignTop;
+                    r.setBottom( r.bottom() - titleOffset );
+                    break;
+            }
+
+            painter->setPen( axisData.palette.color( QPalette::Text ) );
+
+            painter->translate( r.x(), r.y() );
+            if ( angle != 0.0 )
+                painter->rotate( angle );
+
+            QwtText title = axisData.title;
+            title.setRenderFlags( flags );
+            title.draw( painter, QRectF( 0.0, 0.0, r.width(), r.height() ) );
+        }
+
+        painter->restore();
+    }
+
+    painter->restore();
+}
+
+/*!
+  Render the scene into an image
+
+  \param size Size of the image
+  \param dpi Resolution of the image. For dpi <= 0.0 the image
+             gets the resolution of the screen.
+
+  \return Image in QImage::Format_ARGB32_Premultiplied
+  \sa render()
+*/
+QImage QwtPlotScene::toImage( const QSize &size, double dpi ) const
+{
+    QImage image( size, QImage::Format_ARGB32_Premultiplied );
+    if ( image.isNull() )
+        return image;
+
+    if ( dpi > 0.0 )
+    {
+        const int dotsPerMeter = qRound( dpi * 1000.0 / 25.4 );
+        image.setDotsPerMeterX( dotsPerMeter );
+        image.setDotsPerMeterY( dotsPerMeter );
+    }
+
+    image.fill( 0 );
+
+    QPainter painter( &image );
+    render( &painter, QRectF( 0.0, 0.0, size.width(), size.height() ) );
+    painter.end();
+
+    return image;
+}
+
+/*!
+  Render the canvas into a given rectangle
+
+  \param painter Painter
+  \param canvasRect Canvas rectangle
+  \param maps Maps mapping between plot and paint device coordinates
+*/
+void QwtPlotScene::renderCanvas( QPainter *painter,
+    const QRectF &canvasRect, const QwtScaleMap maps[QwtPlot::axisCnt] ) const
+{
+    painter->save();
+
+    painter->fillRect( canvasRect, d_data->canvasBackground );
+    painter->setClipRect( canvasRect );
+
+    const QwtScaleDiv &xScaleDiv = d_data->axisData[QwtPlot::xBottom].scaleDiv;
+    const QwtScaleDiv &yScaleDiv = d_data->axisData[QwtPlot::yLeft].scaleDiv;
+
+    const QList<const QwtPlotItem *> &items = d_data->items;
+    for ( int i = 0; i < items.size(); i++ )
+    {
+        const QwtPlotItem *item = items[i];
+        if ( !item->isVisible() )
+            continue;
+
+        painter->save();
+
+        painter->setRenderHint( QPainter::Antialiasing,
+            item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+        const QwtPlotGrid *grid = dynamic_cast<const QwtPlotGrid *>( item );
+        if ( grid )
+        {
+            // the grid must not ask a plot for its ticks
+            grid->draw( painter, maps[QwtPlot::xBottom], maps[QwtPlot::yLeft],
+                canvasRect, xScaleDiv, yScaleDiv );
+        }
+        else
+        {
+            item->draw( painter, maps[QwtPlot::xBottom], maps[QwtPlot::yLeft],
+                canvasRect );
+        }
+
+        painter->restore();
+    }
+
+    painter->restore();
+}
+
+void QwtPlotScene::layout( const QRectF &rect, LayoutData &layoutData ) const
+{
+    const int m = d_data->margin;
+    QRectF r = rect.adjusted( m, m, -m, -m );
+
+    if ( !d_data->title.isEmpty() )
+    {
+        const double h = d_data->title.heightForWidth(
+            r.width(), d_data->titleFont );
+
+        layoutData.titleRect = QRectF( r.left(), r.top(), r.width(), h );
+        r.setTop( layoutData.titleRect.bottom() + d_data->spacing );
+    }
+
+    /*
+      The dimension of an axis depends on the length of its title,
+      what depends on the dimensions of the orthogonal axes.
+      2 iterations are good enough.
+     */
+
+    double dim[QwtPlot::axisCnt];
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        dim[axisId] = 0.0;
+
+    for ( int iteration = 0; iteration < 2; iteration++ )
+    {
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        {
+            const AxisData &axisData = d_data->axisData[axisId];
+            if ( !axisData.isEnabled )
+                continue;
+
+            QwtScaleDraw scaleDraw;
+            scaleDraw.setAlignment( qwtScaleAlignment( axisId ) );
+            scaleDraw.setScaleDiv( axisData.scaleDiv );
+            for ( int i = 0; i < QwtScaleDiv::NTickTypes; i++ )
+            {
+                scaleDraw.setTickLength(
+                    static_cast<QwtScaleDiv::TickType>( i ),
+                    axisData.tickLength[i] );
+            }
+            scaleDraw.setSpacing( axisData.scaleSpacing );
+            scaleDraw.setPenWidth( axisData.penWidth );
+            scaleDraw.Multiplier = axisData.multiplier;
+
+            double d = axisData.margin
+                + qCeil( scaleDraw.extent( axisData.font ) ) + 1;
+
+            if ( !axisData.title.isEmpty() )
+            {
+                double length;
+                if ( qwtIsHorizontal( axisId ) )
+                    length = r.width() - dim[QwtPlot::yLeft] - dim[QwtPlot::yRight];
+                else
+                    length = r.height() - dim[QwtPlot::xTop] - dim[QwtPlot::xBottom];
+
+                d += axisData.title.heightForWidth(
+                    qMax( length, 0.0 ), axisData.font ) + axisData.spacing;
+            }
+
+            dim[axisId] = d;
+        }
+    }
+
+    layoutData.canvasRect = r.adjusted(
+        dim[QwtPlot::yLeft], dim[QwtPlot::xTop],
+        -dim[QwtPlot::yRight], -dim[QwtPlot::xBottom] );
+
+    const QRectF &cr = layoutData.canvasRect;
+
+    layoutData.scaleRect[QwtPlot::yLeft] = QRectF(
+        cr.left() - dim[QwtPlot::yLeft], cr.top(),
+        dim[QwtPlot::yLeft], cr.height() );
+    layoutData.scaleRect[QwtPlot::yRight] = QRectF(
+        cr.right(), cr.top(), dim[QwtPlot::yRight], cr.height() );
+    layoutData.scaleRect[QwtPlot::xTop] = QRectF(
+        cr.left(), cr.top() - dim[QwtPlot::xTop],
+        cr.width(), dim[QwtPlot::xTop] );
+    layoutData.scaleRect[QwtPlot::xBottom] = QRectF(
+        cr.left(), cr.bottom(), cr.width(), dim[QwtPlot::xBottom] );
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "qwt_plot.h"
+#include "qwt_text.h"
+#include <qlist.h>
+#include <qimage.h>
+
+class QPainter;
+class QPalette;
+class QwtPlotItem;
+class QwtScaleDiv;
+class QwtScaleTransformation;
+
+/*!
+  \brief A widget-free description of a plot, that can be rendered
+         in any thread
+
+  QwtPlotRenderer needs a QwtPlot widget, what limits rendering to the
+  GUI thread. QwtPlotScene holds everything, that is needed to paint
+  a plot as plain values: title, axes with their scale divisions,
+  fonts and colors, layout options and a list of plot items.
+  It lays out and paints itself without accessing any widget, so that
+  many scenes can be rendered concurrently to QImages in worker threads.
+
+  \par Example
+  \verbatim
+QwtPlotScene *scene = new QwtPlotScene();
+scene->setTitle( "Load" );
+scene->setAxisScaleDiv( QwtPlot::xBottom,
+    QwtLinearScaleEngine().divideScale( 0.0, 100.0, 8, 5 ) );
+...
+scene->attachItem( curve );
+
+QFuture<QImage> future = QtConcurrent::run(
+    scene, &QwtPlotScene::toImage, QSize( 800, 600 ), 96.0 );
+\endverbatim
+
+  \note The items are not copied. An item must not be modified
+        or painted by another thread, while a scene referring to it is
+        rendered. When several scenes are rendered in parallel each of
+        them needs its own items.
+  \note A scene must not be rendered by two threads at the same time,
+        as the scale draws and items, that are painted, are not
+        reentrant. Several documents of the same scene have to be
+        rendered one after the other.
+  \note Fonts can only be rendered outside of the GUI thread on platforms
+        supporting it ( see QFontDatabase::supportsThreadedFontRendering() ).
+
+  \sa QwtPlotRenderer
+*/
+class QwtPlotScene
+{
+public:
+    QwtPlotScene();
+    explicit QwtPlotScene( const QwtPlot * );
+
+    virtual ~QwtPlotScene();
+
+    void setTitle( const QwtText & );
+    QwtText title() const;
+
+    void setTitleFont( const QFont & );
+    QFont titleFont() const;
+
+    void setColor( const QColor & );
+    QColor color() const;
+
+    void setBackground( const QBrush & );
+    QBrush background() const;
+
+    void setCanvasBackground( const QBrush & );
+    QBrush canvasBackground() const;
+
+    void setMargin( int );
+    int margin() const;
+
+    void setSpacing( int );
+    int spacing() const;
+
+    void enableAxis( int axisId, bool on = true );
+    bool axisEnabled( int axisId ) const;
+
+    void setAxisScaleDiv( int axisId, const QwtScaleDiv & );
+    const QwtScaleDiv &axisScaleDiv( int axisId ) const;
+
+    void setAxisTransformation( int axisId, QwtScaleTransformation * );
+    const QwtScaleTransformation *axisTransformation( int axisId ) const;
+
+    void setAxisTitle( int axisId, const QwtText & );
+    QwtText axisTitle( int axisId ) const;
+
+    void setAxisFont( int axisId, const QFont & );
+    QFont axisFont( int axisId ) const;
+
+    void setAxisPalette( int axisId, const QPalette & );
+    QPalette axisPalette( int axisId ) const;
+
+    void attachItem( const QwtPlotItem * );
+    void detachItem( const QwtPlotItem * );
+    void detachItems();
+
+    QList<const QwtPlotItem *> items() const;
+
+    QwtScaleMap canvasMap( int axisId, const QRectF &canvasRect ) const;
+
+    virtual void render( QPainter *, const QRectF & ) const;
+    QImage toImage( const QSize &, double dpi = 0.0 ) const;
+
+protected:
+    virtual void renderCanvas( QPainter *, const QRectF &canvasRect,
+        const QwtScaleMap maps[QwtPlot::axisCnt] ) const;
+
+private:
+    QwtPlotScene( const QwtPlotScene & );
+    QwtPlotScene &operator=( const QwtPlotScene & );
+
+    class AxisData;
+    class LayoutData;
+
+    void layout( const QRectF &, LayoutData & ) const;
+
+    class PrivateData;
+    PrivateData *d_data;
+};
@@ -0,0 +1,614 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_traces.h"
+#include "qwt_scale_map.h"
+#include <qpainter.h>
+#include <qpen.h>
+#include <qmath.h>
+#include <float.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+/*
+  What is shared by all traces: the visible samples 
+  and the mapped x coordinates
+ */
+class QwtPlotTraces::Layout
+{
+public:
+    Layout():
+        from( 0 ),
+        to( -1 ),
+        decimated( false )
+    {
+    }
+
+    // range of visible samples
+    int from;
+    int to;
+
+    bool decimated;
+
+    // decimated: the first sample and the center of each column
+    QVector<int> columnStarts;
+    QVector<double> columnCenters;
+
+    // mapped x coordinates, of the samples or of the column borders
+    QVector<double> xValues;
+};
+
+class QwtPlotTraces::PrivateData
+{
+public:
+    PrivateData():
+        traceCount( 0 ),
+        sampleCount( 0 ),
+        x0( 0.0 ),
+        dx( 1.0 ),
+        renderThreadCount( 1 )
+    {
+    }
+
+    int traceCount;
+    int sampleCount;
+    QVector<double> values;
+
+    double x0;
+    double dx;
+
+    QVector<double> offsets;
+    QVector<double> gains;
+
+    // range of the values of each trace
+    QVector<double> minValues;
+    QVector<double> maxValues;
+
+    QPen pen;
+    uint renderThreadCount;
+};
+
+/*!
+  Constructor
+  \param title Title of the item
+*/
+QwtPlotTraces::QwtPlotTraces( const QString &title ):
+    QwtPlotItem( QwtText( title ) )
+{
+    init();
+}
+
+/*!
+  Constructor
+  \param title Title of the item
+*/
+QwtPlotTraces::QwtPlotTraces( const QwtText &title ):
+    QwtPlotItem( title )
+{
+    init();
+}
+
+//! Destructor
+QwtPlotTraces::~QwtPlotTraces()
+{
+    delete d_data;
+}
+
+//! Initialize internal members
+void QwtPlotTraces::init()
+{
+    d_data = new PrivateData;
+    setZ( 20.0 );
+}
+
+/*!
+  Assign the values of all traces
+
+  The offset of a trace is initialized by its index, its gain by 1.0.
+
+  \param traceCount Number of traces
+  \param values Values of all traces. The values of a trace
+                are stored one after the other, so that value( t, i )
+                is at position t * sampleCount() + i.
+
+  \sa setTraceOffset(), setTraceGain()
+*/
+void QwtPlotTraces::setSamples( int traceCount, const QVector<double> &values )
+{
+    traceCount = qMax( traceCount, 0 );
+
+    d_data->values = values;
+    d_data->traceCount = traceCount;
+    d_data->sampleCount = traceCount > 0 ? values.size() / traceCount : 0;
+
+    const int oldCount = d_data->offsets.size();
+
+    d_data->offsets.resize( traceCount );
+    d_data->gains.resize( traceCount );
+    for ( int t = oldCount; t < traceCount; t++ )
+    {
+        d_data->offsets[t] = t;
+        d_data->gains[t] = 1.0;
+    }
+
+    d_data->minValues.resize( traceCount );
+    d_data->maxValues.resize( traceCount );
+
+    for ( int t = 0; t < traceCount; t++ )
+    {
+        const double *v = d_data->values.constData() + t * d_data->sampleCount;
+
+        double min = DBL_MAX;
+        double max = -DBL_MAX;
+
+        for ( int i = 0; i < d_data->sampleCount; i++ )
+        {
+            if ( v[i] < min )
+                min = v[i];
+            if ( v[i] > max )
+                max = v[i];
+        }
+
+        d_data->minValues[t] = min;
+        d_data->maxValues[t] = max;
+    }
+
+    itemChanged();
+}
+
+//! \return Number of traces
+int QwtPlotTraces::traceCount() const
+{
+    return d_data->traceCount;
+}
+
+//! \return Number of samples of each trace
+int QwtPlotTraces::sampleCount() const
+{
+    return d_data->sampleCount;
+}
+
+//! \return Values of all traces
+const QVector<double> &QwtPlotTraces::values() const
+{
+    return d_data->values;
+}
+
+/*!
+  Set the x coordinates of the samples: x( i ) = x0 + i * dx
+
+  \param x0 x coordinate of the first sample
+  \param dx Distance between two samples
+*/
+void QwtPlotTraces::setTimeBase( double x0, double dx )
+{
+    if ( dx <= 0.0 )
+        dx = 1.0;
+
+    if ( x0 != d_data->x0 || dx != d_data->dx )
+    {
+        d_data->x0 = x0;
+        d_data->dx = dx;
+
+        itemChanged();
+    }
+}
+
+//! \return x coordinate of the first sample
+double QwtPlotTraces::x0() const
+{
+    return d_data->x0;
+}
+
+//! \return Distance between two samples
+double QwtPlotTraces::dx() const
+{
+    return d_data->dx;
+}
+
+/*!
+  Set the offset of a trace
+  
+  \param trace Index of the trace
+  \param offset Offset, that is added to the values of the trace
+  \sa traceOffset(), setTraceGain()
+*/
+void QwtPlotTraces::setTraceOffset( int trace, double offset )
+{
+    if ( trace >= 0 && trace < d_data->traceCount && 
+        d_data->offsets[trace] != offset )
+    {
+        d_data->offsets[trace] = offset;
+        itemChanged();
+    }
+}
+
+/*!
+  \return Offset of a trace
+  \param trace Index of the trace
+  \sa setTraceOffset()
+*/
+double QwtPlotTraces::traceOffset( int trace ) const
+{
+    if ( trace < 0 || trace >= d_data->traceCount )
+        return 0.0;
+
+    return d_data->offsets[trace];
+}
+
+/*!
+  Set the gain of a trace
+  
+  \param trace Index of the trace
+  \param gain Factor, the values of the trace are multiplied with
+  \sa traceGain(), setTraceOffset()
+*/
+void QwtPlotTraces::setTraceGain( int trace, double gain )
+{
+    if ( trace >= 0 && trace < d_data->traceCount &&
+        d_data->gains[trace] != gain )
+    {
+        d_data->gains[trace] = gain;
+        itemChanged();
+    }
+}
+
+/*!
+  \return Gain of a trace
+  \param trace Index of the trace
+  \sa setTraceGain()
+*/
+double QwtPlotTraces::traceGain( int trace ) const
+{
+    if ( trace < 0 || trace >= d_data->traceCount )
+        return 1.0;
+
+    return d_data->gains[trace];
+}
+
+/*!
+  Assign the pen, that is used for all traces
+
+  \param pen Pen
+  \sa pen()
+*/
+void QwtPlotTraces::setPen( const QPen &pen )
+{
+    if ( pen != d_data->pen )
+    {
+        d_data->pen = pen;
+        itemChanged();
+    }
+}
+
+/*!
+  \return Pen, that is used for all traces
+  \sa setPen()
+*/
+const QPen &QwtPlotTraces::pen() const
+{
+    return d_data->pen;
+}
+
+/*!
+   Reducing the traces can be done in parallel on a multicore system.
+
+   \param numThreads Number of threads to be used for rendering.
+                     If numThreads is set to 0, the system specific
+                     ideal thread count is used.
+
+   The default thread count is 1 ( = no additional threads )
+
+   \sa renderThreadCount(), renderTraces()
+*/
+void QwtPlotTraces::setRenderThreadCount( uint numThreads )
+{
+    d_data->renderThreadCount = numThreads;
+}
+
+/*!
+   \return Number of threads to be used for rendering.
+           If numThreads is set to 0, the system specific
+           ideal thread count is used.
+
+   \sa setRenderThreadCount(), renderTraces()
+*/
+uint QwtPlotTraces::renderThreadCount() const
+{
+    return d_data->renderThreadCount;
+}
+
+/*!
+  \return Bounding rectangle of all traces, including their 
+          offsets and gains
+*/
+QRectF QwtPlotTraces::boundingRect() const
+{
+    const PrivateData *d = d_data;
+
+    double yMin = DBL_MAX;
+    double yMax = -DBL_MAX;
+
+    for ( int t = 0; t < d->traceCount; t++ )
+    {
+        if ( d->minValues[t] > d->maxValues[t] )
+            continue;
+
+        const double y1 = d->offsets[t] + d->gains[t] * d->minValues[t];
+        const double y2 = d->offsets[t] + d->gains[t] * d->maxValues[t];
+
+        yMin = qMin( yMin, qMin( y1, y2 ) );
+        yMax = qMax( yMax, qMax( y1, y2 ) );
+    }
+
+    if ( d->sampleCount <= 0 || yMin > yMax )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    const double xMax = d->x0 + ( d->sampleCount - 1 ) * d->dx;
+    return QRectF( d->x0, yMin, xMax - d->x0, yMax - yMin );
+}
+
+/*!
+  Draw the traces
+
+  The visible samples and the mapped x coordinates are calculated 
+  once for all traces. Then the traces are mapped and reduced by
+  renderTraces() - in parallel, when enabled - and painted 
+  with the same pen.
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rect of the canvas in painter coordinates
+
+  \sa setRenderThreadCount()
+*/
+void QwtPlotTraces::draw( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect ) const
+{
+    Q_UNUSED( canvasRect );
+
+    const PrivateData *d = d_data;
+    if ( d->traceCount <= 0 || d->sampleCount <= 0 )
+        return;
+
+    // the visible samples, with one more on each side
+
+    const double i1 = ( qMin( xMap.s1(), xMap.s2() ) - d->x0 ) / d->dx;
+    const double i2 = ( qMax( xMap.s1(), xMap.s2() ) - d->x0 ) / d->dx;
+
+    Layout layout;
+    const double maxIndex = d->sampleCount;
+
+    layout.from = qMax( qFloor( qBound( -1.0, i1, maxIndex ) ), 0 );
+    layout.to = qMin( qCeil( qBound( -1.0, i2, maxIndex ) ), 
+        d->sampleCount - 1 );
+
+    if ( layout.from > layout.to )
+        return;
+
+    const double p1 = qFloor( qMin( xMap.p1(), xMap.p2() ) );
+    const double p2 = qCeil( qMax( xMap.p1(), xMap.p2() ) );
+    const int numColumns = int( p2 - p1 );
+
+    const int numSamples = layout.to - layout.from + 1;
+
+    if ( numColumns > 0 && numSamples > 4 * numColumns )
+    {
+        layout.decimated = true;
+
+        layout.columnStarts.resize( numColumns + 1 );
+        layout.columnCenters.resize( numColumns );
+
+        for ( int c = 0; c <= numColumns; c++ )
+        {
+            const double x = xMap.invTransform( p1 + c );
+
+            // bounded before the conversion, as the index might exceed INT_MAX
+            const double index = qBound( double( layout.from ),
+                ::ceil( ( x - d->x0 ) / d->dx ), double( layout.to + 1 ) );
+
+            layout.columnStarts[c] = int( index );
+        }
+
+        if ( xMap.p1() > xMap.p2() )
+        {
+            // the first sample needs to be in the first column
+            for ( int c = 0; c <= numColumns / 2; c++ )
+                qSwap( layout.columnStarts[c], layout.columnStarts[numColumns - c] );
+        }
+
+        for ( int c = 0; c < numColumns; c++ )
+        {
+            const double x = ( xMap.p1() <= xMap.p2() ) 
+                ? p1 + c + 0.5 : p2 - c - 0.5;
+
+            layout.columnCenters[c] = x;
+        }
+
+        layout.xValues.resize( 2 );
+        layout.xValues[0] = xMap.transform( d->x0 + layout.from * d->dx );
+        layout.xValues[1] = xMap.transform( d->x0 + layout.to * d->dx );
+    }
+    else
+    {
+        layout.xValues.resize( numSamples );
+        for ( int i = 0; i < numSamples; i++ )
+        {
+            layout.xValues[i] = 
+                xMap.transform( d->x0 + ( layout.from + i ) * d->dx );
+        }
+    }
+
+    QVector<QPolygonF> polygons( d->traceCount );
+
+#if !defined(QT_NO_QFUTURE)
+    uint numThreads = d->renderThreadCount;
+
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    // not worth the overhead for small sets
+    const qint64 numValues = qint64( numSamples ) * d->traceCount;
+    numThreads = qMin( numThreads, uint( qMax( numValues / 100000, qint64( 1 ) ) ) );
+    numThreads = qMin( numThreads, uint( d->traceCount ) );
+
+    const int numTraces = d->traceCount / numThreads;
+
+    QList< QFuture<void> > futures;
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        const int firstTrace = i * numTraces;
+
+        if ( i == numThreads - 1 )
+        {
+            renderTraces( &layout, yMap, 
+                firstTrace, d->traceCount - 1, &polygons );
+        }
+        else
+        {
+            futures += QtConcurrent::run(
+                this, &QwtPlotTraces::renderTraces, &layout, yMap,
+                firstTrace, firstTrace + numTraces - 1, &polygons );
+        }
+    }
+
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#else
+    renderTraces( &layout, yMap, 0, d->traceCount - 1, &polygons );
+#endif
+
+    painter->setPen( d->pen );
+    painter->setBrush( Qt::NoBrush );
+
+    for ( int t = 0; t < polygons.size(); t++ )
+    {
+        const QPolygonF &polygon = polygons[t];
+        if ( polygon.size() > 1 )
+            painter->drawPolyline( polygon.constData(), polygon.size() );
+    }
+}
+
+/*!
+  Map and reduce a range of traces
+
+  Traces, that are completely outside of the canvas, are left empty.
+
+  \param layout Visible samples and mapped x coordinates
+  \param yMap Maps y-values into pixel coordinates.
+  \param firstTrace Index of the first trace
+  \param lastTrace Index of the last trace
+  \param polygons Polylines of all traces, where the 
+                  polylines of the range are stored
+
+  \note Called from worker threads
+*/
+void QwtPlotTraces::renderTraces( const Layout *layout, 
+    const QwtScaleMap &yMap, int firstTrace, int lastTrace, 
+    QVector<QPolygonF> *polygons ) const
+{
+    const PrivateData *d = d_data;
+
+    const double yMin = qMin( yMap.p1(), yMap.p2() );
+    const double yMax = qMax( yMap.p1(), yMap.p2() );
+
+    const int numSamples = layout->to - layout->from + 1;
+
+    for ( int t = firstTrace; t <= lastTrace; t++ )
+    {
+        const double offset = d->offsets[t];
+        const double gain = d->gains[t];
+
+        const double *values = d->values.constData() 
+            + t * d->sampleCount + layout->from;
+
+        QPolygonF &polygon = ( *polygons )[t];
+
+        double top = DBL_MAX;
+        double bottom = -DBL_MAX;
+
+        if ( !layout->decimated )
+        {
+            polygon.resize( numSamples );
+            QPointF *points = polygon.data();
+
+            for ( int i = 0; i < numSamples; i++ )
+            {
+                const double y = yMap.transform( offset + gain * values[i] );
+
+                points[i].rx() = layout->xValues[i];
+                points[i].ry() = y;
+
+                top = qMin( top, y );
+                bottom = qMax( bottom, y );
+            }
+        }
+        else
+        {
+            const int numColumns = layout->columnCenters.size();
+
+            polygon.resize( 0 );
+            polygon.reserve( 4 * numColumns + 2 );
+
+            polygon += QPointF( layout->xValues[0], 
+                yMap.transform( offset + gain * values[0] ) );
+
+            for ( int c = 0; c < numColumns; c++ )
+            {
+                const int i1 = layout->columnStarts[c] - layout->from;
+                const int i2 = layout->columnStarts[c + 1] - layout->from - 1;
+
+                if ( i1 > i2 )
+                    continue;
+
+                double min = values[i1];
+                double max = values[i1];
+
+                for ( int i = i1 + 1; i <= i2; i++ )
+                {
+                    if ( values[i] < min )
+                        min = values[i];
+                    if ( values[i] > max )
+                        max = values[i];
+                }
+
+                const double x = layout->columnCenters[c];
+
+                double yFirst = yMap.transform( offset + gain * values[i1] );
+                double y1 = yMap.transform( offset + gain * min );
+                double y2 = yMap.transform( offset + gain * max );
+                double yLast = yMap.transform( offset + gain * values[i2] );
+
+                // the extremum closer to the first value comes first
+                if ( qAbs( yFirst - y2 ) < qAbs( yFirst - y1 ) )
+                    qSwap( y1, y2 );
+
+                polygon += QPointF( x, yFirst );
+                polygon += QPointF( x, y1 );
+                polygon += QPointF( x, y2 );
+                polygon += QPointF( x, yLast );
+
+                top = qMin( top, qMin( y1, y2 ) );
+                bottom = qMax( bottom, qMax( y1, y2 ) );
+            }
+
+            polygon += QPointF( layout->xValues[1], 
+                yMap.transform( offset + gain * values[numSamples - 1] ) );
+        }
+
+        if ( top > yMax || bottom < yMin )
+            polygon.resize( 0 ); // outside of the canvas
+    }
+}
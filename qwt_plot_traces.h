@@ -0,0 +1,74 @@
+#pragma once
+
+#include "qwt_plot_item.h"
+#include <qvector.h>
+#include <qpolygon.h>
+
+class QPen;
+
+/*!
+  \brief A plot item, that displays many traces stacked on top of
+         each other
+
+  Seismic or EEG displays show hundreds of uniformly sampled traces, each
+  shifted by an offset. Instead of one QwtPlotCurve per trace
+  QwtPlotTraces paints all of them from one buffer of values with
+  one pen and one legend entry.
+
+  The sample i of trace t is displayed at
+  ( x0 + i * dx, offset( t ) + gain( t ) * value( t, i ) ).
+
+  The x coordinates are mapped once for all traces. When there are more
+  samples than pixel columns, each trace is reduced to the first, 
+  the minimum, the maximum and the last value of each column. 
+  The traces can be processed in parallel - see setRenderThreadCount().
+*/
+class QwtPlotTraces: public QwtPlotItem
+{
+public:
+    explicit QwtPlotTraces( const QString &title = QString::null );
+    explicit QwtPlotTraces( const QwtText &title );
+
+    virtual ~QwtPlotTraces();
+
+    void setSamples( int traceCount, const QVector<double> &values );
+
+    int traceCount() const;
+    int sampleCount() const;
+
+    const QVector<double> &values() const;
+
+    void setTimeBase( double x0, double dx );
+    double x0() const;
+    double dx() const;
+
+    void setTraceOffset( int trace, double offset );
+    double traceOffset( int trace ) const;
+
+    void setTraceGain( int trace, double gain );
+    double traceGain( int trace ) const;
+
+    void setPen( const QPen & );
+    const QPen &pen() const;
+
+    void setRenderThreadCount( uint numThreads );
+    uint renderThreadCount() const;
+
+    virtual void draw( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect ) const;
+
+    virtual QRectF boundingRect() const;
+
+protected:
+    class Layout;
+
+    virtual void renderTraces( const Layout *, const QwtScaleMap &yMap,
+        int firstTrace, int lastTrace, QVector<QPolygonF> *polygons ) const;
+
+private:
+    void init();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
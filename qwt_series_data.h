@@ -3,6 +3,8 @@
 #include <qvector.h>
 #include <qrect.h>
 
+class QwtScaleMap;
+
 /*!
    \brief Abstract interface for iterating over samples
 
@@ -40,6 +42,16 @@ public:
      */
     virtual QRectF boundingRect() const = 0;
 
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+    virtual void setRectOfInterest( const QRectF & );
+
+    virtual const double *transformedX( 
+        const QwtScaleMap &, int from, int to ) const;
+
+    virtual uint revision() const;
+
 protected:
     //! Can be used to cache a calculated bounding rectangle
     mutable QRectF d_boundingRect;
@@ -61,6 +73,117 @@ QwtSeriesData<T>::~QwtSeriesData()
 {
 }
 
+/*!
+   \brief Find the samples with x coordinates inside of an interval
+
+   Series, that know about their samples being ordered by 
+   increasing x coordinates, can implement a fast lookup, that
+   is used to restrict painting to the visible samples.
+
+   \param x1 Lower limit of the interval
+   \param x2 Upper limit of the interval
+   \param from Index of the first sample with x1 <= x
+   \param to Index of the last sample with x <= x2 
+              ( to < from, when no sample is inside )
+
+   \return false, when the lookup is not supported, what is the
+           default implementation.
+ */
+template <typename T>
+bool QwtSeriesData<T>::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    Q_UNUSED( x1 );
+    Q_UNUSED( x2 );
+    Q_UNUSED( from );
+    Q_UNUSED( to );
+
+    return false;
+}
+
+/*!
+   \brief Find the range of y coordinates of a subset of the samples
+
+   Series, that can calculate the range faster than iterating
+   over the samples - f.e. from precalculated summaries - allow to 
+   decimate a curve to the minimum and maximum of each pixel column.
+
+   \param from Index of the first sample
+   \param to Index of the last sample
+   \param min Minimum of the y coordinates
+   \param max Maximum of the y coordinates
+
+   \return false, when the calculation is not supported, what is the
+           default implementation.
+ */
+template <typename T>
+bool QwtSeriesData<T>::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    Q_UNUSED( from );
+    Q_UNUSED( to );
+    Q_UNUSED( min );
+    Q_UNUSED( max );
+
+    return false;
+}
+
+/*!
+   \brief Set the rectangle, that is about to be painted
+
+   Series, that load their samples on demand, can use the rectangle
+   to prefetch the visible samples. The default implementation
+   does nothing.
+
+   \param rect Visible rectangle in plot coordinates
+ */
+template <typename T>
+void QwtSeriesData<T>::setRectOfInterest( const QRectF &rect )
+{
+    Q_UNUSED( rect );
+}
+
+/*!
+   \brief Map the x coordinates of a range of samples
+
+   Series sharing their x coordinates with other series - see 
+   QwtMultiChannelData - can map them once for all of them.
+
+   \param xMap Maps x-values into pixel coordinates.
+   \param from Index of the first sample
+   \param to Index of the last sample
+
+   \return Array of the x coordinates of the samples from-to in paint
+           device coordinates, or NULL, what is the default implementation.
+ */
+template <typename T>
+const double *QwtSeriesData<T>::transformedX( 
+    const QwtScaleMap &xMap, int from, int to ) const
+{
+    Q_UNUSED( xMap );
+    Q_UNUSED( from );
+    Q_UNUSED( to );
+
+    return NULL;
+}
+
+/*!
+   \brief Revision of the samples
+
+   Series, that replace their samples without being reassigned to the
+   plot item - see QwtSharedSeriesData - increment the revision,
+   so that the plot item can rebuild what it has calculated from
+   the previous samples.
+
+   \return Revision of the samples, the default implementation
+           always returns 0.
+ */
+template <typename T>
+uint QwtSeriesData<T>::revision() const
+{
+    return 0;
+}
+
 /*!
   \brief Template class for data, that is organized as QVector
 
@@ -190,5 +313,256 @@ private:
     int d_size;
 };
 
+/*!
+  \brief Minimum and maximum of an array of values
+
+  The values are compared in their native type, NaNs are ignored.
+
+  \param values Array of values
+  \param from Index of the first value
+  \param to Index of the last value
+  \param min Minimum
+  \param max Maximum
+
+  \return false, when there is no valid value in the range
+*/
+template <typename T>
+inline bool qwtValueRange( const T *values, int from, int to, T &min, T &max )
+{
+    int i = from;
+    while ( i <= to && !( values[i] == values[i] ) )
+        i++;
+
+    if ( i > to )
+        return false;
+
+    T v1 = values[i];
+    T v2 = values[i];
+
+    for ( ; i <= to; i++ )
+    {
+        const T value = values[i];
+
+        if ( value < v1 )
+            v1 = value;
+        else if ( value > v2 )
+            v2 = value;
+    }
+
+    min = v1;
+    max = v2;
+
+    return true;
+}
+
+/*!
+  \brief Data class containing two pointers to memory blocks of values,
+         that are not double
+
+  Storing samples as float or as the integers of an ADC needs half
+  of the memory or less, compared to QwtCPointerData. The values are
+  converted to double, when a sample is requested. Bounding rectangle, 
+  y ranges and the lookup of x intervals are calculated on the 
+  values in their native type.
+
+  \warning The values are not copied and have to be valid,
+           as long as the series is in use.
+ */
+template <typename T>
+class QwtTypedCPointerData: public QwtSeriesData<QPointF>
+{
+public:
+    QwtTypedCPointerData( const T *x, const T *y, int size );
+
+    virtual QRectF boundingRect() const;
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+    const T *xData() const;
+    const T *yData() const;
+
+private:
+    const T *d_x;
+    const T *d_y;
+    int d_size;
+
+    mutable int d_sorted;
+};
+
+/*!
+  Constructor
+
+  \param x Array of x values
+  \param y Array of y values
+  \param size Size of the x and y arrays
+*/
+template <typename T>
+QwtTypedCPointerData<T>::QwtTypedCPointerData( 
+        const T *x, const T *y, int size ):
+    d_x( x ),
+    d_y( y ),
+    d_size( size ),
+    d_sorted( -1 )
+{
+}
+
+/*!
+  \brief Calculate the bounding rect
+
+  The bounding rectangle is calculated once by iterating over the
+  values and is stored for all following requests.
+
+  \return Bounding rectangle
+*/
+template <typename T>
+QRectF QwtTypedCPointerData<T>::boundingRect() const
+{
+    if ( d_boundingRect.width() < 0 )
+    {
+        T x1, x2, y1, y2;
+        if ( qwtValueRange( d_x, 0, d_size - 1, x1, x2 ) &&
+            qwtValueRange( d_y, 0, d_size - 1, y1, y2 ) )
+        {
+            d_boundingRect.setCoords( x1, y1, x2, y2 );
+        }
+        else
+        {
+            d_boundingRect = QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+        }
+    }
+
+    return d_boundingRect;
+}
+
+//! \return Size of the data set
+template <typename T>
+int QwtTypedCPointerData<T>::size() const
+{
+    return d_size;
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+template <typename T>
+QPointF QwtTypedCPointerData<T>::sample( int i ) const
+{
+    return QPointF( d_x[i], d_y[i] );
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval
+  by a binary search.
+
+  The first call checks, if the x values are increasing,
+  otherwise the lookup is not supported.
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+
+  \return false, when the x values are not increasing
+*/
+template <typename T>
+bool QwtTypedCPointerData<T>::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( d_sorted < 0 )
+    {
+        d_sorted = 1;
+        for ( int i = 1; i < d_size; i++ )
+        {
+            if ( !( d_x[i] >= d_x[i - 1] ) )
+            {
+                d_sorted = 0;
+                break;
+            }
+        }
+    }
+
+    if ( d_sorted == 0 )
+        return false;
+
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    // first value >= x1
+    int lo = 0;
+    int hi = d_size;
+    while ( lo < hi )
+    {
+        const int mid = ( lo + hi ) / 2;
+        if ( d_x[mid] < x1 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    from = lo;
+
+    // first value > x2
+    hi = d_size;
+    while ( lo < hi )
+    {
+        const int mid = ( lo + hi ) / 2;
+        if ( d_x[mid] <= x2 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    to = lo - 1;
+
+    return true;
+}
+
+/*!
+  Calculate the minimum and maximum of the y coordinates
+  by iterating over the values in their native type.
+
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param min Minimum of the y coordinates
+  \param max Maximum of the y coordinates
+
+  \return false, when there are no valid values in the range
+*/
+template <typename T>
+bool QwtTypedCPointerData<T>::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    T y1, y2;
+    if ( !qwtValueRange( d_y, qMax( from, 0 ), 
+        qMin( to, d_size - 1 ), y1, y2 ) )
+    {
+        return false;
+    }
+
+    min = y1;
+    max = y2;
+
+    return true;
+}
+
+//! \return Array of the x-values
+template <typename T>
+const T *QwtTypedCPointerData<T>::xData() const
+{
+    return d_x;
+}
+
+//! \return Array of the y-values
+template <typename T>
+const T *QwtTypedCPointerData<T>::yData() const
+{
+    return d_y;
+}
+
 QRectF qwtBoundingRect(
     const QwtSeriesData<QPointF> &, int from = 0, int to = -1 );
+
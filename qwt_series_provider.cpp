@@ -0,0 +1,123 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_series_provider.h"
+#include "qwt_mapped_series_data.h"
+#include "qwt_interval.h"
+
+//! Constructor
+QwtSeriesProvider::QwtSeriesProvider()
+{
+}
+
+//! Destructor
+QwtSeriesProvider::~QwtSeriesProvider()
+{
+}
+
+class QwtFileSeriesProvider::PrivateData
+{
+public:
+    PrivateData( const QString &fileName ):
+        series( fileName )
+    {
+    }
+
+    QwtMappedSeriesData series;
+};
+
+/*!
+  Constructor
+  \param fileName File in the format of QwtMappedSeriesData
+*/
+QwtFileSeriesProvider::QwtFileSeriesProvider( const QString &fileName )
+{
+    d_data = new PrivateData( fileName );
+}
+
+//! Destructor
+QwtFileSeriesProvider::~QwtFileSeriesProvider()
+{
+    delete d_data;
+}
+
+//! \return true, when the file could be opened
+bool QwtFileSeriesProvider::isValid() const
+{
+    return d_data->series.isValid();
+}
+
+//! \return Name of the file
+QString QwtFileSeriesProvider::fileName() const
+{
+    return d_data->series.fileName();
+}
+
+//! \return Bounding rectangle from the summary of the file
+QRectF QwtFileSeriesProvider::boundingRect() const
+{
+    return d_data->series.boundingRect();
+}
+
+/*!
+  \brief Load the samples of an interval
+
+  When there are more than 2 * resolution samples inside of the
+  interval, they are divided into resolution buckets, 
+  and the minimum and the maximum of each bucket are returned.
+
+  \param interval Interval of the x axis
+  \param resolution Number of buckets
+  \return Samples
+*/
+QVector<QPointF> QwtFileSeriesProvider::samples( 
+    const QwtInterval &interval, int resolution ) const
+{
+    QVector<QPointF> points;
+
+    const QwtMappedSeriesData &series = d_data->series;
+
+    int from, to;
+    if ( !interval.isValid() || !series.indexRange( 
+        interval.minValue(), interval.maxValue(), from, to ) || from > to )
+    {
+        return points;
+    }
+
+    const int numSamples = to - from + 1;
+
+    if ( resolution <= 0 || numSamples <= 2 * resolution )
+    {
+        points.resize( numSamples );
+        for ( int i = 0; i < numSamples; i++ )
+            points[i] = series.sample( from + i );
+
+        return points;
+    }
+
+    points.reserve( 2 * resolution );
+
+    for ( int i = 0; i < resolution; i++ )
+    {
+        const int i1 = from + int( qint64( numSamples ) * i / resolution );
+        const int i2 = from + int( qint64( numSamples ) * ( i + 1 ) / resolution ) - 1;
+
+        double min, max;
+        if ( i1 > i2 || !series.yRange( i1, i2, min, max ) )
+            continue;
+
+        const double x = 0.5 * ( series.sample( i1 ).x() + series.sample( i2 ).x() );
+
+        points += QPointF( x, min );
+        if ( max > min )
+            points += QPointF( x, max );
+    }
+
+    return points;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <qvector.h>
+#include <qpoint.h>
+#include <qrect.h>
+#include <qstring.h>
+
+class QwtInterval;
+
+/*!
+  \brief Abstract interface for loading samples of a series on demand
+
+  A provider delivers the samples of a window of the x axis
+  in a requested resolution. It is used by QwtAsyncSeriesData, that calls 
+  samples() in worker threads, so that a slow backing store - a 
+  compressed file or a database - doesn't block painting.
+
+  \sa QwtAsyncSeriesData, QwtFileSeriesProvider
+*/
+class QwtSeriesProvider
+{
+public:
+    QwtSeriesProvider();
+    virtual ~QwtSeriesProvider();
+
+    /*!
+      \return Bounding rectangle of all samples
+      \note Called from the GUI thread
+     */
+    virtual QRectF boundingRect() const = 0;
+
+    /*!
+      \brief Load the samples of an interval
+
+      When the interval has more samples than the resolution, they
+      can be reduced, but the result has to be ordered by increasing x 
+      coordinates and inside of the interval.
+
+      \param interval Interval of the x axis
+      \param resolution Number of samples, that are sufficient to
+                        display the interval
+
+      \return Samples
+      \note Called from worker threads, maybe several at the same time
+     */
+    virtual QVector<QPointF> samples( 
+        const QwtInterval &interval, int resolution ) const = 0;
+
+private:
+    QwtSeriesProvider( const QwtSeriesProvider & );
+    QwtSeriesProvider &operator=( const QwtSeriesProvider & );
+};
+
+/*!
+  \brief Provider for the files of QwtMappedSeriesData
+
+  The samples of an interval are reduced to the minimum and
+  maximum of buckets, that are taken from the summary of the file.
+
+  \sa QwtMappedSeriesData
+*/
+class QwtFileSeriesProvider: public QwtSeriesProvider
+{
+public:
+    explicit QwtFileSeriesProvider( const QString &fileName );
+    virtual ~QwtFileSeriesProvider();
+
+    bool isValid() const;
+    QString fileName() const;
+
+    virtual QRectF boundingRect() const;
+
+    virtual QVector<QPointF> samples( 
+        const QwtInterval &, int resolution ) const;
+
+private:
+    class PrivateData;
+    PrivateData *d_data;
+};
@@ -0,0 +1,62 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_series_snapshot.h"
+#include <qcoreapplication.h>
+#include <qthread.h>
+
+#if !defined(QT_NO_QFUTURE)
+#include <qtconcurrentrun.h>
+#endif
+
+static void qwtDeleteNode( QwtSeriesSnapshotNode *node )
+{
+    delete node;
+}
+
+//! Constructor, initializing the reference count to 1
+QwtSeriesSnapshotNode::QwtSeriesSnapshotNode():
+    d_ref( 1 )
+{
+}
+
+//! Destructor
+QwtSeriesSnapshotNode::~QwtSeriesSnapshotNode()
+{
+}
+
+//! Increment the reference count
+void QwtSeriesSnapshotNode::ref()
+{
+    d_ref.ref();
+}
+
+/*!
+  Decrement the reference count and delete the node,
+  when it is not referenced anymore.
+
+  In the GUI thread the node is deleted by a thread
+  of the global thread pool.
+*/
+void QwtSeriesSnapshotNode::deref()
+{
+    if ( d_ref.deref() )
+        return;
+
+#if !defined(QT_NO_QFUTURE)
+    const QCoreApplication *app = QCoreApplication::instance();
+    if ( app && QThread::currentThread() == app->thread() )
+    {
+        QtConcurrent::run( qwtDeleteNode, this );
+        return;
+    }
+#endif
+
+    qwtDeleteNode( this );
+}
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qatomic.h>
+
+template <typename T> class QwtSharedSeriesData;
+
+/*!
+  \brief Base class of the reference counted nodes of QwtSeriesSnapshot
+
+  When the last reference is released in the GUI thread, the node
+  is deleted by a thread of the global thread pool, so that destroying
+  a large series doesn't block the user interface.
+*/
+class QwtSeriesSnapshotNode
+{
+public:
+    QwtSeriesSnapshotNode();
+    virtual ~QwtSeriesSnapshotNode();
+
+    void ref();
+    void deref();
+
+private:
+    QwtSeriesSnapshotNode( const QwtSeriesSnapshotNode & );
+    QwtSeriesSnapshotNode &operator=( const QwtSeriesSnapshotNode & );
+
+    QAtomicInt d_ref;
+};
+
+/*!
+  \brief Reference counted handle of an immutable series
+
+  A snapshot takes ownership of a series and deletes it, when the
+  last handle referring to it is destroyed. Handles can be copied and
+  passed between threads, but the series must not be modified
+  after it has been wrapped into a snapshot.
+
+  \sa QwtSharedSeriesData
+*/
+template <typename T>
+class QwtSeriesSnapshot
+{
+public:
+    QwtSeriesSnapshot();
+    explicit QwtSeriesSnapshot( QwtSeriesData<T> * );
+    QwtSeriesSnapshot( const QwtSeriesSnapshot<T> & );
+    ~QwtSeriesSnapshot();
+
+    QwtSeriesSnapshot<T> &operator=( const QwtSeriesSnapshot<T> & );
+
+    bool isNull() const;
+    QwtSeriesData<T> *data() const;
+
+private:
+    friend class QwtSharedSeriesData<T>;
+
+    class Node: public QwtSeriesSnapshotNode
+    {
+    public:
+        explicit Node( QwtSeriesData<T> *data ):
+            series( data )
+        {
+        }
+
+        virtual ~Node()
+        {
+            delete series;
+        }
+
+        QwtSeriesData<T> *series;
+    };
+
+    void reset( Node * );
+
+    Node *d_node;
+};
+
+//! Constructor of a null snapshot
+template <typename T>
+QwtSeriesSnapshot<T>::QwtSeriesSnapshot():
+    d_node( NULL )
+{
+}
+
+/*!
+  Constructor
+
+  \param series Series, the snapshot takes ownership of
+*/
+template <typename T>
+QwtSeriesSnapshot<T>::QwtSeriesSnapshot( QwtSeriesData<T> *series ):
+    d_node( series ? new Node( series ) : NULL )
+{
+}
+
+//! Copy constructor
+template <typename T>
+QwtSeriesSnapshot<T>::QwtSeriesSnapshot( const QwtSeriesSnapshot<T> &other ):
+    d_node( other.d_node )
+{
+    if ( d_node )
+        d_node->ref();
+}
+
+//! Destructor
+template <typename T>
+QwtSeriesSnapshot<T>::~QwtSeriesSnapshot()
+{
+    if ( d_node )
+        d_node->deref();
+}
+
+//! Assignment operator
+template <typename T>
+QwtSeriesSnapshot<T> &QwtSeriesSnapshot<T>::operator=(
+    const QwtSeriesSnapshot<T> &other )
+{
+    if ( other.d_node )
+        other.d_node->ref();
+
+    reset( other.d_node );
+    return *this;
+}
+
+//! \return true, when the snapshot has no series
+template <typename T>
+inline bool QwtSeriesSnapshot<T>::isNull() const
+{
+    return d_node == NULL;
+}
+
+//! \return Series of the snapshot
+template <typename T>
+inline QwtSeriesData<T> *QwtSeriesSnapshot<T>::data() const
+{
+    return d_node ? d_node->series : NULL;
+}
+
+// replaces the node, taking over a reference to it
+template <typename T>
+void QwtSeriesSnapshot<T>::reset( Node *node )
+{
+    if ( d_node )
+        d_node->deref();
+
+    d_node = node;
+}
+
+/*!
+  \brief Series, that can be replaced from any thread
+
+  QwtSharedSeriesData is assigned to a plot item once and forwards
+  to the latest published snapshot of a series. A worker thread
+  prepares a new series and passes it with publish(). The plot item
+  keeps painting the previous snapshot, until the next paint operation
+  picks up the newest one. Snapshots, that are not used anymore,
+  are deleted by a worker thread.
+
+  \par Example
+  \verbatim
+QwtSharedSeriesData<QPointF> *shared = new QwtSharedSeriesData<QPointF>();
+curve->setData( shared );
+
+// worker thread
+shared->publish( new QwtPointSeriesData( samples ) );
+QMetaObject::invokeMethod( plot, "replot", Qt::QueuedConnection );
+\endverbatim
+
+  \note The published snapshot is picked up by boundingRect() and
+        setRectOfInterest(), that is called before a series item is
+        painted. So all samples of a paint operation are from the same
+        snapshot. The plot item has to be painted in one thread.
+  \note Each snapshot, that has been picked up, increments the
+        revision(), so that QwtPlotCurve rebuilds its spatial index.
+*/
+template <typename T>
+class QwtSharedSeriesData: public QwtSeriesData<T>
+{
+public:
+    QwtSharedSeriesData();
+    virtual ~QwtSharedSeriesData();
+
+    void publish( QwtSeriesData<T> * );
+    void publish( const QwtSeriesSnapshot<T> & );
+
+    QwtSeriesSnapshot<T> snapshot() const;
+
+    virtual int size() const;
+    virtual T sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+    virtual void setRectOfInterest( const QRectF & );
+
+    virtual const double *transformedX( 
+        const QwtScaleMap &, int from, int to ) const;
+
+    virtual uint revision() const;
+
+private:
+    typedef typename QwtSeriesSnapshot<T>::Node Node;
+
+    bool update() const;
+
+    QAtomicPointer<Node> d_published;
+    mutable QwtSeriesSnapshot<T> d_current;
+    mutable uint d_revision;
+};
+
+//! Constructor
+template <typename T>
+QwtSharedSeriesData<T>::QwtSharedSeriesData():
+    d_published( NULL ),
+    d_revision( 0 )
+{
+}
+
+//! Destructor
+template <typename T>
+QwtSharedSeriesData<T>::~QwtSharedSeriesData()
+{
+    Node *node = d_published.fetchAndStoreOrdered( NULL );
+    if ( node )
+        node->deref();
+}
+
+/*!
+  Publish a new series
+
+  Can be called from any thread. A snapshot, that has been published
+  before and was not picked up yet, is dropped.
+
+  \param series Series, the snapshot takes ownership of
+*/
+template <typename T>
+void QwtSharedSeriesData<T>::publish( QwtSeriesData<T> *series )
+{
+    publish( QwtSeriesSnapshot<T>( series ) );
+}
+
+/*!
+  Publish a snapshot
+
+  Can be called from any thread. A snapshot, that has been published
+  before and was not picked up yet, is dropped.
+
+  \param snapshot Snapshot
+*/
+template <typename T>
+void QwtSharedSeriesData<T>::publish( const QwtSeriesSnapshot<T> &snapshot )
+{
+    Node *node = snapshot.d_node;
+    if ( node )
+        node->ref(); // the reference is owned by d_published
+
+    Node *previous = d_published.fetchAndStoreOrdered( node );
+    if ( previous )
+        previous->deref();
+}
+
+/*!
+  \return Snapshot, that is painted
+  \note Must be called from the thread painting the plot item
+*/
+template <typename T>
+QwtSeriesSnapshot<T> QwtSharedSeriesData<T>::snapshot() const
+{
+    update();
+    return d_current;
+}
+
+//! \return Number of samples of the current snapshot
+template <typename T>
+int QwtSharedSeriesData<T>::size() const
+{
+    const QwtSeriesData<T> *series = d_current.data();
+    return series ? series->size() : 0;
+}
+
+/*!
+  \return Sample of the current snapshot
+  \param i Index
+*/
+template <typename T>
+T QwtSharedSeriesData<T>::sample( int i ) const
+{
+    return d_current.data()->sample( i );
+}
+
+/*!
+  \return Bounding rectangle of the newest snapshot
+*/
+template <typename T>
+QRectF QwtSharedSeriesData<T>::boundingRect() const
+{
+    update();
+
+    const QwtSeriesData<T> *series = d_current.data();
+    if ( series == NULL )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    return series->boundingRect();
+}
+
+/*!
+  Forwarded to the current snapshot
+  \sa QwtSeriesData<T>::indexRange()
+*/
+template <typename T>
+bool QwtSharedSeriesData<T>::indexRange(
+    double x1, double x2, int &from, int &to ) const
+{
+    const QwtSeriesData<T> *series = d_current.data();
+    return series && series->indexRange( x1, x2, from, to );
+}
+
+/*!
+  Forwarded to the current snapshot
+  \sa QwtSeriesData<T>::yRange()
+*/
+template <typename T>
+bool QwtSharedSeriesData<T>::yRange(
+    int from, int to, double &min, double &max ) const
+{
+    const QwtSeriesData<T> *series = d_current.data();
+    return series && series->yRange( from, to, min, max );
+}
+
+/*!
+  Forwarded to the current snapshot
+  \sa QwtSeriesData<T>::transformedX()
+*/
+template <typename T>
+const double *QwtSharedSeriesData<T>::transformedX(
+    const QwtScaleMap &xMap, int from, int to ) const
+{
+    const QwtSeriesData<T> *series = d_current.data();
+    return series ? series->transformedX( xMap, from, to ) : NULL;
+}
+
+/*!
+  \return Number of snapshots, that have been picked up
+  \sa QwtSeriesData<T>::revision()
+*/
+template <typename T>
+uint QwtSharedSeriesData<T>::revision() const
+{
+    return d_revision;
+}
+
+/*!
+  Pick up the newest snapshot and forward the rectangle to it
+
+  \param rect Visible rectangle in plot coordinates
+  \sa QwtSeriesData<T>::setRectOfInterest()
+*/
+template <typename T>
+void QwtSharedSeriesData<T>::setRectOfInterest( const QRectF &rect )
+{
+    update();
+
+    QwtSeriesData<T> *series = d_current.data();
+    if ( series )
+        series->setRectOfInterest( rect );
+}
+
+// picks up the newest snapshot, returns true when it has been replaced
+template <typename T>
+bool QwtSharedSeriesData<T>::update() const
+{
+    /*
+      Taking the node out of d_published transfers its reference
+      to d_current, so that a concurrent publish() can't release it.
+     */
+    Node *node = const_cast< QAtomicPointer<Node> & >( 
+        d_published ).fetchAndStoreOrdered( NULL );
+
+    if ( node == NULL )
+        return false;
+
+    d_current.reset( node );
+    d_revision++;
+
+    return true;
+}
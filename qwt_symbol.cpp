@@ -10,6 +10,10 @@
 #include "qwt_symbol.h"
 #include <qapplication.h>
 #include <qpainter.h>
+#include <qpaintengine.h>
+#include <qimage.h>
+#include <qvector.h>
+#include <qmutex.h>
 #include <qmath.h>
 
 namespace QwtTriangle
@@ -418,6 +422,104 @@ static inline void qwtDrawHexagonSymbols( QPainter *painter,
     }
 }
 
+static void qwtDrawSymbols( QPainter *painter,
+    const QPointF *points, int numPoints, const QwtSymbol &symbol )
+{
+    switch ( symbol.style() )
+    {
+        case QwtSymbol::Ellipse:
+        {
+            qwtDrawEllipseSymbols( painter, points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Rect:
+        {
+            qwtDrawRectSymbols( painter, points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Diamond:
+        {
+            qwtDrawDiamondSymbols( painter, points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Cross:
+        {
+            qwtDrawLineSymbols( painter, Qt::Horizontal | Qt::Vertical,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::XCross:
+        {
+            qwtDrawXCrossSymbols( painter, points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Triangle:
+        case QwtSymbol::UTriangle:
+        {
+            qwtDrawTriangleSymbols( painter, QwtTriangle::Up,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::DTriangle:
+        {
+            qwtDrawTriangleSymbols( painter, QwtTriangle::Down,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::RTriangle:
+        {
+            qwtDrawTriangleSymbols( painter, QwtTriangle::Right,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::LTriangle:
+        {
+            qwtDrawTriangleSymbols( painter, QwtTriangle::Left,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::HLine:
+        {
+            qwtDrawLineSymbols( painter, Qt::Horizontal,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::VLine:
+        {
+            qwtDrawLineSymbols( painter, Qt::Vertical,
+                points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Star1:
+        {
+            qwtDrawStar1Symbols( painter, points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Star2:
+        {
+            qwtDrawStar2Symbols( painter, points, numPoints, symbol );
+            break;
+        }
+        case QwtSymbol::Hexagon:
+        {
+            qwtDrawHexagonSymbols( painter, points, numPoints, symbol );
+            break;
+        }
+        default:;
+    }
+}
+
+static inline double qwtDevicePixelRatio( const QPainter *painter )
+{
+#if QT_VERSION >= 0x050100
+    if ( painter->device() )
+        return painter->device()->devicePixelRatio();
+#else
+    Q_UNUSED( painter );
+#endif
+    return 1.0;
+}
+
 class QwtSymbol::PrivateData
 {
 public:
@@ -426,7 +528,9 @@ public:
         style( st ),
         size( sz ),
         brush( br ),
-        pen( pn )
+        pen( pn ),
+        cachePolicy( QwtSymbol::AutoCache ),
+        subPixelSteps( 1 )
     {
     }
 
@@ -443,6 +547,36 @@ public:
     QSize size;
     QBrush brush;
     QPen pen;
+
+    QwtSymbol::CachePolicy cachePolicy;
+    int subPixelSteps;
+
+    /*
+      The sprites are rendered for the device pixel ratio, the number
+      of sub pixel steps and the antialiasing of the painter. As painting
+      might happen in several threads, the cache is protected by a mutex.
+      The revision is incremented by invalidateCache(), so that sprites,
+      that have been rendered from outdated attributes, are not stored.
+     */
+    struct Cache
+    {
+        Cache():
+            revision( 0 ),
+            pixelRatio( 0.0 ),
+            steps( 0 ),
+            antialiased( false )
+        {
+        }
+
+        QMutex mutex;
+        int revision;
+
+        QVector<QImage> sprites;
+        QPointF center;
+        double pixelRatio;
+        int steps;
+        bool antialiased;
+    } cache;
 };
 
 /*!
@@ -482,6 +616,9 @@ QwtSymbol::QwtSymbol( const QwtSymbol &other )
 {
     d_data = new PrivateData( other.style(), other.brush(),
         other.pen(), other.size() );
+
+    d_data->cachePolicy = other.cachePolicy();
+    d_data->subPixelSteps = other.subPixelSteps();
 };
 
 //! Destructor
@@ -493,7 +630,15 @@ QwtSymbol::~QwtSymbol()
 //! \brief Assignment operator
 QwtSymbol &QwtSymbol::operator=( const QwtSymbol &other )
 {
-    *d_data = *other.d_data;
+    d_data->style = other.d_data->style;
+    d_data->size = other.d_data->size;
+    d_data->brush = other.d_data->brush;
+    d_data->pen = other.d_data->pen;
+    d_data->cachePolicy = other.d_data->cachePolicy;
+    d_data->subPixelSteps = other.d_data->subPixelSteps;
+
+    invalidateCache();
+
     return *this;
 }
 
@@ -526,6 +671,7 @@ void QwtSymbol::setSize( int width, int height )
         height = width;
 
     d_data->size = QSize( width, height );
+    invalidateCache();
 }
 
 /*!
@@ -537,7 +683,10 @@ void QwtSymbol::setSize( int width, int height )
 void QwtSymbol::setSize( const QSize &size )
 {
     if ( size.isValid() )
+    {
         d_data->size = size;
+        invalidateCache();
+    }
 }
 
 /*!
@@ -560,6 +709,7 @@ const QSize& QwtSymbol::size() const
 void QwtSymbol::setBrush( const QBrush &brush )
 {
     d_data->brush = brush;
+    invalidateCache();
 }
 
 /*!
@@ -582,6 +732,7 @@ const QBrush& QwtSymbol::brush() const
 void QwtSymbol::setPen( const QPen &pen )
 {
     d_data->pen = pen;
+    invalidateCache();
 }
 
 /*!
@@ -636,6 +787,8 @@ void QwtSymbol::setColor( const QColor &color )
             d_data->pen.setColor( color );
         }
     }
+
+    invalidateCache();
 }
 
 /*!
@@ -645,6 +798,9 @@ void QwtSymbol::setColor( const QColor &color )
   one by one, as a couple of layout calculations and setting of pen/brush
   can be done once for the complete array.
 
+  Depending on the cachePolicy() the symbol is rendered only once
+  into a sprite, that is copied to the positions of the points.
+
   \param painter Painter
   \param points Array of points
   \param numPoints Number of points
@@ -655,91 +811,232 @@ void QwtSymbol::drawSymbols( QPainter *painter,
     if ( numPoints <= 0 )
         return;
 
+    if ( drawSprites( painter, points, numPoints ) )
+        return;
+
     painter->save();
+    qwtDrawSymbols( painter, points, numPoints, *this );
+    painter->restore();
+}
 
-    switch ( d_data->style )
+/*!
+  Copy cached sprites of the symbol to the points
+
+  \param painter Painter
+  \param points Array of points
+  \param numPoints Number of points
+
+  \return false, when the cache can't be used for the painter
+*/
+bool QwtSymbol::drawSprites( QPainter *painter,
+    const QPointF *points, int numPoints ) const
+{
+    if ( d_data->cachePolicy == NoCache )
+        return false;
+
+    if ( d_data->style < Ellipse || d_data->style >= UserStyle )
+        return false;
+
+    if ( d_data->size.isEmpty() )
+        return false;
+
+    // world and view transformation, but without the device pixel ratio
+    const QTransform transform = painter->combinedTransform();
+    if ( transform.type() > QTransform::TxTranslate )
+        return false;
+
+    if ( d_data->cachePolicy == AutoCache )
     {
-        case QwtSymbol::Ellipse:
-        {
-            qwtDrawEllipseSymbols( painter, points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::Rect:
-        {
-            qwtDrawRectSymbols( painter, points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::Diamond:
-        {
-            qwtDrawDiamondSymbols( painter, points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::Cross:
-        {
-            qwtDrawLineSymbols( painter, Qt::Horizontal | Qt::Vertical,
-                points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::XCross:
-        {
-            qwtDrawXCrossSymbols( painter, points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::Triangle:
-        case QwtSymbol::UTriangle:
-        {
-            qwtDrawTriangleSymbols( painter, QwtTriangle::Up,
-                points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::DTriangle:
-        {
-            qwtDrawTriangleSymbols( painter, QwtTriangle::Down,
-                points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::RTriangle:
-        {
-            qwtDrawTriangleSymbols( painter, QwtTriangle::Right,
-                points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::LTriangle:
-        {
-            qwtDrawTriangleSymbols( painter, QwtTriangle::Left,
-                points, numPoints, *this );
-            break;
-        }
-        case QwtSymbol::HLine:
+        const QPaintEngine *engine = painter->paintEngine();
+        if ( engine == NULL || engine->type() != QPaintEngine::Raster )
+            return false;
+    }
+
+    const double pixelRatio = qwtDevicePixelRatio( painter );
+    const bool antialiased =
+        painter->testRenderHint( QPainter::Antialiasing );
+
+    const int steps = d_data->subPixelSteps;
+
+    /*
+      Antialiased symbols are expected at their exact positions.
+      Without sub pixel steps AutoCache paints them.
+     */
+    if ( antialiased && steps == 1 && d_data->cachePolicy == AutoCache )
+        return false;
+
+    QVector<QImage> sprites;
+    QPointF center;
+
+    PrivateData::Cache &cache = d_data->cache;
+
+    int revision;
+    {
+        QMutexLocker locker( &cache.mutex );
+
+        if ( !cache.sprites.isEmpty() && cache.pixelRatio == pixelRatio
+            && cache.steps == steps && cache.antialiased == antialiased )
         {
-            qwtDrawLineSymbols( painter, Qt::Horizontal,
-                points, numPoints, *this );
-            break;
+            sprites = cache.sprites;
+            center = cache.center;
         }
-        case QwtSymbol::VLine:
+
+        revision = cache.revision;
+    }
+
+    if ( sprites.isEmpty() )
+    {
+        // rendering the sprites without blocking other threads
+
+        const QSize size = boundingSize() + QSize( 2, 2 );
+        center = QPointF( 0.5 * size.width(), 0.5 * size.height() );
+
+        sprites.resize( steps * steps );
+        for ( int i = 0; i < sprites.size(); i++ )
         {
-            qwtDrawLineSymbols( painter, Qt::Vertical,
-                points, numPoints, *this );
-            break;
+            // offsets in device pixels
+            const QPointF pos = center +
+                QPointF( i % steps, i / steps ) / ( steps * pixelRatio );
+
+            QImage sprite( qCeil( size.width() * pixelRatio ),
+                qCeil( size.height() * pixelRatio ),
+                QImage::Format_ARGB32_Premultiplied );
+#if QT_VERSION >= 0x050100
+            sprite.setDevicePixelRatio( pixelRatio );
+#endif
+            sprite.fill( 0 );
+
+            QPainter spritePainter( &sprite );
+            spritePainter.setRenderHint(
+                QPainter::Antialiasing, antialiased );
+            qwtDrawSymbols( &spritePainter, &pos, 1, *this );
+            spritePainter.end();
+
+            sprites[i] = sprite;
         }
-        case QwtSymbol::Star1:
+
+        QMutexLocker locker( &cache.mutex );
+        if ( cache.revision == revision )
         {
-            qwtDrawStar1Symbols( painter, points, numPoints, *this );
-            break;
+            cache.sprites = sprites;
+            cache.center = center;
+            cache.pixelRatio = pixelRatio;
+            cache.steps = steps;
+            cache.antialiased = antialiased;
         }
-        case QwtSymbol::Star2:
+    }
+
+    /*
+      The sprites are copied to integer device pixel positions,
+      choosing the one with the sub pixel offset closest to the point.
+     */
+
+    const double dx = transform.dx();
+    const double dy = transform.dy();
+
+    const QImage *spriteData = sprites.constData();
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const double x = ( points[i].x() + dx - center.x() ) * pixelRatio;
+        const double y = ( points[i].y() + dy - center.y() ) * pixelRatio;
+
+        int ix = qFloor( x );
+        int iy = qFloor( y );
+
+        int sx = qRound( ( x - ix ) * steps );
+        if ( sx >= steps )
         {
-            qwtDrawStar2Symbols( painter, points, numPoints, *this );
-            break;
+            ix++;
+            sx = 0;
         }
-        case QwtSymbol::Hexagon:
+
+        int sy = qRound( ( y - iy ) * steps );
+        if ( sy >= steps )
         {
-            qwtDrawHexagonSymbols( painter, points, numPoints, *this );
-            break;
+            iy++;
+            sy = 0;
         }
-        default:;
+
+        const QPointF pos( ix / pixelRatio - dx, iy / pixelRatio - dy );
+        painter->drawImage( pos, spriteData[ sy * steps + sx ] );
     }
-    painter->restore();
+
+    return true;
+}
+
+/*!
+  Set the cache policy
+
+  The default policy is QwtSymbol::AutoCache
+
+  \param policy Cache policy
+  \sa CachePolicy, cachePolicy(), setSubPixelSteps()
+*/
+void QwtSymbol::setCachePolicy( CachePolicy policy )
+{
+    if ( d_data->cachePolicy != policy )
+    {
+        d_data->cachePolicy = policy;
+        invalidateCache();
+    }
+}
+
+/*!
+  \return Cache policy
+  \sa CachePolicy, setCachePolicy()
+*/
+QwtSymbol::CachePolicy QwtSymbol::cachePolicy() const
+{
+    return d_data->cachePolicy;
+}
+
+/*!
+  Set the number of sub pixel positions, for which a sprite is cached
+
+  With the default setting of 1 the cached symbols are aligned
+  to device pixels, what might displace them by up to half a pixel.
+  With n steps n * n sprites are rendered with offsets of 1 / n
+  device pixels in both directions.
+
+  As antialiased symbols are expected at their exact positions,
+  QwtSymbol::AutoCache doesn't use sprites for antialiased painters,
+  unless more than one step has been set.
+
+  \param steps Number of sub pixel positions in each direction,
+               bounded to [1, 4]
+  \sa subPixelSteps(), setCachePolicy()
+*/
+void QwtSymbol::setSubPixelSteps( int steps )
+{
+    steps = qBound( 1, steps, 4 );
+    if ( d_data->subPixelSteps != steps )
+    {
+        d_data->subPixelSteps = steps;
+        invalidateCache();
+    }
+}
+
+/*!
+  \return Number of sub pixel positions, for which a sprite is cached
+  \sa setSubPixelSteps()
+*/
+int QwtSymbol::subPixelSteps() const
+{
+    return d_data->subPixelSteps;
+}
+
+/*!
+  Clear the cached sprites
+
+  Derived classes need to call invalidateCache(), when they
+  change attributes affecting the appearance of the symbol.
+*/
+void QwtSymbol::invalidateCache()
+{
+    QMutexLocker locker( &d_data->cache.mutex );
+    d_data->cache.sprites.clear();
+    d_data->cache.revision++;
 }
 
 //!  \return Size of the bounding rectangle of a symbol
@@ -796,6 +1093,7 @@ QSize QwtSymbol::boundingSize() const
 void QwtSymbol::setStyle( QwtSymbol::Style style )
 {
     d_data->style = style;
+    invalidateCache();
 }
 
 /*!
@@ -76,6 +76,35 @@ public:
         UserStyle = 1000
     };
 
+    /*!
+      Depending on the cache policy the symbol is rendered once into an
+      image ( sprite ), that is copied to the positions of the points.
+      This is much faster than painting the symbol for each point,
+      but it only works for paint devices, where images can be copied
+      pixel by pixel and with painters that are not scaled or rotated.
+
+      \sa setCachePolicy(), cachePolicy(), setSubPixelSteps()
+     */
+    enum CachePolicy
+    {
+        //! Always paint the symbols
+        NoCache,
+
+        /*!
+          Use the cache, when painting to a raster paint device
+          ( QImage, or widgets on most platforms ). Antialiased
+          symbols are only cached with more than one sub pixel step.
+          This is the default.
+         */
+        AutoCache,
+
+        /*!
+          Use the cache for all paint devices, as long as the
+          painter is not scaled or rotated.
+         */
+        Cache
+    };
+
 public:
     QwtSymbol( Style = NoSymbol );
     QwtSymbol( Style, const QBrush &, const QPen &, const QSize & );
@@ -101,16 +130,26 @@ public:
     void setStyle( Style );
     Style style() const;
 
+    void setCachePolicy( CachePolicy );
+    CachePolicy cachePolicy() const;
+
+    void setSubPixelSteps( int );
+    int subPixelSteps() const;
+
     void drawSymbol( QPainter *, const QPointF & ) const;
     void drawSymbols( QPainter *, const QPolygonF & ) const;
 
+    virtual void drawSymbols( QPainter *,
+        const QPointF *, int numPoints ) const;
+
     virtual QSize boundingSize() const;
 
 protected:
-    virtual void drawSymbols( QPainter *,
-        const QPointF *, int numPoints ) const;
+    void invalidateCache();
 
 private:
+    bool drawSprites( QPainter *, const QPointF *, int numPoints ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
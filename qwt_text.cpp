@@ -9,14 +9,13 @@
 
 #include "qwt_text.h"
 #include "qwt_text_engine.h"
+#include "qwt_painter.h"
 #include <qmap.h>
 #include <qfont.h>
 #include <qcolor.h>
 #include <qpen.h>
 #include <qbrush.h>
 #include <qpainter.h>
-#include <qapplication.h>
-#include <qdesktopwidget.h>
 #include <qmath.h>
 
 class QwtText::PrivateData
@@ -341,7 +340,7 @@ double QwtText::heightForWidth( double width, const QFont &defaultFont ) const
     // We want to calculate in screen metrics. So
     // we need a font that uses screen metrics
 
-    const QFont font( usedFont( defaultFont ), QApplication::desktop() );
+    const QFont font( usedFont( defaultFont ), QwtPainter::screenDevice() );
 
     double h = 0;
 
@@ -385,7 +384,7 @@ QSizeF QwtText::textSize( const QFont &defaultFont ) const
     // We want to calculate in screen metrics. So
     // we need a font that uses screen metrics
 
-    const QFont font( usedFont( defaultFont ), QApplication::desktop() );
+    const QFont font( usedFont( defaultFont ), QwtPainter::screenDevice() );
 
     if ( !d_layoutCache->textSize.isValid()
         || d_layoutCache->font != font )
@@ -448,7 +447,7 @@ void QwtText::draw( QPainter *painter, const QRectF &rect ) const
         // We want to calculate in screen metrics. So
         // we need a font that uses screen metrics
 
-        const QFont font( painter->font(), QApplication::desktop() );
+        const QFont font( painter->font(), QwtPainter::screenDevice() );
 
         double left, right, top, bottom;
         QwtPlainTextEngine::textMargins(
@@ -10,9 +10,9 @@
 #include "qwt_text_engine.h"
 #include "qwt_painter.h"
 #include <qpainter.h>
-#include <qpixmap.h>
 #include <qimage.h>
 #include <qmap.h>
+#include <qmutex.h>
 #include <qwidget.h>
 
 class AscentCache
@@ -22,6 +22,9 @@ public:
     {
         const QString fontKey = font.key();
 
+        // texts might be layouted in render threads too
+        QMutexLocker locker( &d_mutex );
+
         QMap<QString, int>::const_iterator it =
             d_ascentCache.find( fontKey );
         if ( it == d_ascentCache.end() )
@@ -40,22 +43,22 @@ private:
         static const QColor white( Qt::white );
 
         const QFontMetrics fm( font );
-        QPixmap pm( fm.width( dummy ), fm.height() );
-        pm.fill( white );
 
-        QPainter p( &pm );
+        // QImage instead of QPixmap: it can be used outside the GUI thread
+        QImage img( fm.width( dummy ), fm.height(), QImage::Format_RGB32 );
+        img.fill( white.rgb() );
+
+        QPainter p( &img );
         p.setFont( font );
-        p.drawText( 0, 0,  pm.width(), pm.height(), 0, dummy );
+        p.drawText( 0, 0,  img.width(), img.height(), 0, dummy );
         p.end();
 
-        const QImage img = pm.toImage();
-
         int row = 0;
         for ( row = 0; row < img.height(); row++ )
         {
-            const QRgb *line = ( const QRgb * )img.scanLine( row );
+            const QRgb *line = ( const QRgb * )img.constScanLine( row );
 
-            const int w = pm.width();
+            const int w = img.width();
             for ( int col = 0; col < w; col++ )
             {
                 if ( line[col] != white.rgb() )
@@ -67,8 +70,10 @@ private:
     }
 
     static QMap<QString, int> d_ascentCache;
+    static QMutex d_mutex;
 };
 QMap<QString, int> AscentCache::d_ascentCache;
+QMutex AscentCache::d_mutex;
 
 /*!
    Find the height for a given width
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "qwt_series_data.h"
+#include <qmath.h>
+
+/*!
+  \brief Series of uniformly sampled values
+
+  The x coordinates are not stored, but calculated from the position
+  of the first sample and the distance between the samples:
+  x( i ) = x0 + i * dx. The y coordinates are stored in an array of 
+  values of type T - f.e. float or qint16 for the output of an ADC -
+  and are calculated by: y( i ) = value[i] * scale + offset.
+
+  For a trace of 100M qint16 values this needs 200MB, where
+  QwtPointArrayData would need 1.6GB.
+
+  As the x coordinates are increasing the samples inside of an interval
+  are found in O(1) - see indexRange(). The bounding rectangle only 
+  needs to iterate over the values.
+
+  \par Example
+  \verbatim
+const qint16 *values = ...
+curve->setData( new QwtUniformData<qint16>( 0.0, 1.0 / 48000, values, size ) );
+\endverbatim
+
+  \note dx has to be > 0.
+*/
+template <typename T>
+class QwtUniformData: public QwtSeriesData<QPointF>
+{
+public:
+    QwtUniformData( double x0, double dx, const QVector<T> &values );
+    QwtUniformData( double x0, double dx, const T *values, int size );
+
+    void setScale( double scale, double offset = 0.0 );
+    double scale() const;
+    double offset() const;
+
+    double x0() const;
+    double dx() const;
+
+    const T *values() const;
+
+    virtual int size() const;
+    virtual QPointF sample( int i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual bool indexRange( double x1, double x2, int &from, int &to ) const;
+    virtual bool yRange( int from, int to, double &min, double &max ) const;
+
+private:
+    double d_x0;
+    double d_dx;
+    double d_scale;
+    double d_offset;
+
+    QVector<T> d_vector;
+    const T *d_values;
+    int d_size;
+};
+
+/*!
+  Constructor
+
+  \param x0 x coordinate of the first sample
+  \param dx Distance between two samples
+  \param values Values, that are implicitly shared
+*/
+template <typename T>
+QwtUniformData<T>::QwtUniformData( 
+        double x0, double dx, const QVector<T> &values ):
+    d_x0( x0 ),
+    d_dx( dx ),
+    d_scale( 1.0 ),
+    d_offset( 0.0 ),
+    d_vector( values ),
+    d_values( d_vector.constData() ),
+    d_size( d_vector.size() )
+{
+}
+
+/*!
+  Constructor
+
+  \param x0 x coordinate of the first sample
+  \param dx Distance between two samples
+  \param values Array of values
+  \param size Number of values
+
+  \warning The values are not copied and have to be valid,
+           as long as the series is in use.
+*/
+template <typename T>
+QwtUniformData<T>::QwtUniformData( 
+        double x0, double dx, const T *values, int size ):
+    d_x0( x0 ),
+    d_dx( dx ),
+    d_scale( 1.0 ),
+    d_offset( 0.0 ),
+    d_values( values ),
+    d_size( size )
+{
+}
+
+/*!
+  Set the conversion from values to y coordinates:
+  y = value * scale + offset
+
+  \param scale Scale factor
+  \param offset Offset
+  \sa scale(), offset()
+*/
+template <typename T>
+void QwtUniformData<T>::setScale( double scale, double offset )
+{
+    d_scale = scale;
+    d_offset = offset;
+
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+}
+
+//! \return Scale factor of the values
+template <typename T>
+double QwtUniformData<T>::scale() const
+{
+    return d_scale;
+}
+
+//! \return Offset of the values
+template <typename T>
+double QwtUniformData<T>::offset() const
+{
+    return d_offset;
+}
+
+//! \return x coordinate of the first sample
+template <typename T>
+double QwtUniformData<T>::x0() const
+{
+    return d_x0;
+}
+
+//! \return Distance between two samples
+template <typename T>
+double QwtUniformData<T>::dx() const
+{
+    return d_dx;
+}
+
+//! \return Array of values
+template <typename T>
+const T *QwtUniformData<T>::values() const
+{
+    return d_values;
+}
+
+//! \return Number of samples
+template <typename T>
+int QwtUniformData<T>::size() const
+{
+    return d_size;
+}
+
+/*!
+  Return the sample at position i
+
+  \param i Index
+  \return Sample at position i
+*/
+template <typename T>
+QPointF QwtUniformData<T>::sample( int i ) const
+{
+    return QPointF( d_x0 + i * d_dx, d_values[i] * d_scale + d_offset );
+}
+
+/*!
+  \brief Calculate the bounding rect
+
+  The x coordinates are known from x0() and dx(), the y coordinates
+  are calculated from the minimum and maximum of the values.
+  The rectangle is stored for all following requests.
+
+  \return Bounding rectangle
+*/
+template <typename T>
+QRectF QwtUniformData<T>::boundingRect() const
+{
+    if ( d_boundingRect.width() < 0 )
+    {
+        double min, max;
+        if ( yRange( 0, d_size - 1, min, max ) )
+        {
+            d_boundingRect = QRectF( d_x0, min, 
+                ( d_size - 1 ) * d_dx, max - min );
+        }
+        else
+        {
+            d_boundingRect = QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+        }
+    }
+
+    return d_boundingRect;
+}
+
+/*!
+  Find the samples with x coordinates inside of an interval in O(1)
+
+  \param x1 Lower limit of the interval
+  \param x2 Upper limit of the interval
+  \param from Index of the first sample with x1 <= x
+  \param to Index of the last sample with x <= x2 
+  \return true
+*/
+template <typename T>
+bool QwtUniformData<T>::indexRange( 
+    double x1, double x2, int &from, int &to ) const
+{
+    if ( d_dx <= 0.0 )
+        return false;
+
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    // bounding before converting to int, NaNs end up in an empty range
+
+    const double i1 = qBound( 0.0, ( x1 - d_x0 ) / d_dx, double( d_size ) );
+    const double i2 = qBound( -1.0, ( x2 - d_x0 ) / d_dx, d_size - 1.0 );
+
+    from = qCeil( i1 );
+    to = qFloor( i2 );
+
+    return true;
+}
+
+/*!
+  Calculate the minimum and maximum of the y coordinates
+  by iterating over the values in their native type.
+
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param min Minimum of the y coordinates
+  \param max Maximum of the y coordinates
+
+  \return false, when there are no valid values in the range
+*/
+template <typename T>
+bool QwtUniformData<T>::yRange( 
+    int from, int to, double &min, double &max ) const
+{
+    from = qMax( from, 0 );
+    to = qMin( to, d_size - 1 );
+
+    T v1, v2;
+    if ( !qwtValueRange( d_values, from, to, v1, v2 ) )
+        return false;
+
+    min = v1 * d_scale + d_offset;
+    max = v2 * d_scale + d_offset;
+
+    if ( min > max )
+        qSwap( min, max );
+
+    return true;
+}